@@ -64,6 +64,7 @@ static bool has_infile = false;
 #define MAXQUIT 10
 static cmd_func_t quit_helpers[MAXQUIT];
 static int quit_helper_cnt = 0;
+static cmd_hook_t cmd_hook = NULL;
 
 static void init_in();
 
@@ -178,6 +179,8 @@ static bool interpret_cmda(int argc, char *argv[])
     while (next_cmd && strcmp(argv[0], next_cmd->name) != 0)
         next_cmd = next_cmd->next;
     if (next_cmd) {
+        if (cmd_hook)
+            cmd_hook(next_cmd->name);
         ok = next_cmd->operation(argc, argv);
         if (!ok)
             record_error();
@@ -206,6 +209,12 @@ static bool interpret_cmd(char *cmdline)
     return ok;
 }
 
+/* Set function to be called with the name of every command before it runs */
+void set_cmd_hook(cmd_hook_t hook)
+{
+    cmd_hook = hook;
+}
+
 /* Set function to be executed as part of program exit */
 void add_quit_helper(cmd_func_t qf)
 {
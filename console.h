@@ -53,6 +53,10 @@ void add_param(char *name, int *valp, char *summary, setter_func_t setter);
 /* Extract integer from text and store at loc */
 bool get_int(char *vname, int *loc);
 
+/* Optionally supply function invoked with the name of each command run */
+typedef void (*cmd_hook_t)(const char *name);
+void set_cmd_hook(cmd_hook_t hook);
+
 /* Add function to be executed as part of program exit */
 void add_quit_helper(cmd_func_t qf);
 
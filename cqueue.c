@@ -0,0 +1,290 @@
+/* Lock-free multi-producer, multi-consumer queue with hazard pointers */
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "cqueue.h"
+
+/* Hazard pointers per handle: a consumer protects the dummy node at the head
+ * and its successor, a producer only the node at the tail.
+ */
+#define CQ_HAZARDS 2
+
+/* Keep at least this many retired nodes before scanning for hazards, so that
+ * the cost of a scan is spread over many removals.
+ */
+#define CQ_RETIRE_MIN 64
+
+/* Head and tail are updated by different threads; keep them apart */
+#define CQ_CACHE_LINE 64
+
+typedef struct cq_node {
+    _Atomic(struct cq_node *) next;
+    void *value;
+} cq_node_t;
+
+struct cq_handle {
+    cq_t *q;
+    _Atomic(cq_node_t *) hazard[CQ_HAZARDS];
+    atomic_bool active;
+    struct cq_handle *next; /* Handles are never unlinked, only reused */
+    cq_node_t **retired;
+    size_t nretired, retired_capacity;
+};
+
+/* The queue always holds a dummy node at @head; values live in its
+ * successors.  @tail points to the last node or, while an insertion is in
+ * progress, to the one before it.
+ */
+struct cq {
+    _Alignas(CQ_CACHE_LINE) _Atomic(cq_node_t *) head;
+    _Alignas(CQ_CACHE_LINE) _Atomic(cq_node_t *) tail;
+    _Alignas(CQ_CACHE_LINE) _Atomic(cq_handle_t *) handles;
+    atomic_int nhandles;
+};
+
+static cq_node_t *cq_new_node(void *value)
+{
+    cq_node_t *node = malloc(sizeof(cq_node_t));
+    if (!node)
+        return NULL;
+    atomic_init(&node->next, NULL);
+    node->value = value;
+    return node;
+}
+
+cq_t *cq_new(void)
+{
+    size_t size = (sizeof(cq_t) + CQ_CACHE_LINE - 1) & ~(CQ_CACHE_LINE - 1);
+    cq_t *q = aligned_alloc(CQ_CACHE_LINE, size);
+    if (!q)
+        return NULL;
+
+    cq_node_t *dummy = cq_new_node(NULL);
+    if (!dummy) {
+        free(q);
+        return NULL;
+    }
+    atomic_init(&q->head, dummy);
+    atomic_init(&q->tail, dummy);
+    atomic_init(&q->handles, NULL);
+    atomic_init(&q->nhandles, 0);
+    return q;
+}
+
+void cq_free(cq_t *q)
+{
+    if (!q)
+        return;
+
+    cq_node_t *node = atomic_load(&q->head);
+    while (node) {
+        cq_node_t *next = atomic_load(&node->next);
+        free(node);
+        node = next;
+    }
+
+    cq_handle_t *h = atomic_load(&q->handles);
+    while (h) {
+        cq_handle_t *next = h->next;
+        for (size_t i = 0; i < h->nretired; i++)
+            free(h->retired[i]);
+        free(h->retired);
+        free(h);
+        h = next;
+    }
+    free(q);
+}
+
+cq_handle_t *cq_attach(cq_t *q)
+{
+    cq_handle_t *h;
+    for (h = atomic_load(&q->handles); h; h = h->next) {
+        bool idle = false;
+        if (atomic_compare_exchange_strong(&h->active, &idle, true))
+            return h;
+    }
+
+    h = malloc(sizeof(cq_handle_t));
+    if (!h)
+        return NULL;
+    h->q = q;
+    for (int i = 0; i < CQ_HAZARDS; i++)
+        atomic_init(&h->hazard[i], NULL);
+    atomic_init(&h->active, true);
+    h->retired = NULL;
+    h->nretired = h->retired_capacity = 0;
+
+    /* Counted for the retire threshold of cq_retire() */
+    atomic_fetch_add(&q->nhandles, 1);
+    h->next = atomic_load(&q->handles);
+    while (!atomic_compare_exchange_weak(&q->handles, &h->next, h))
+        ;
+    return h;
+}
+
+static int cq_ptr_cmp(const void *a, const void *b)
+{
+    uintptr_t x = (uintptr_t) *(void *const *) a;
+    uintptr_t y = (uintptr_t) *(void *const *) b;
+    return (x > y) - (x < y);
+}
+
+/* Free the retired nodes of h that no hazard pointer refers to.
+ * Handles are only ever pushed in front of the list and never unlinked, so
+ * the handles from a snapshot of its head onwards stay the same and are all
+ * read.  A handle pushed after the snapshot can only protect nodes that are
+ * still reachable, never retired ones, so skipping it is safe.
+ */
+static void cq_scan(cq_handle_t *h)
+{
+    cq_handle_t *first = atomic_load(&h->q->handles);
+    size_t capacity = 0;
+    for (cq_handle_t *o = first; o; o = o->next)
+        capacity += CQ_HAZARDS;
+    void **hazards = malloc(capacity * sizeof(void *));
+    if (!hazards)
+        return;
+
+    size_t n = 0;
+    for (cq_handle_t *o = first; o; o = o->next) {
+        for (int i = 0; i < CQ_HAZARDS; i++) {
+            void *p = atomic_load(&o->hazard[i]);
+            if (p)
+                hazards[n++] = p;
+        }
+    }
+    qsort(hazards, n, sizeof(void *), cq_ptr_cmp);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < h->nretired; i++) {
+        cq_node_t *node = h->retired[i];
+        if (bsearch(&node, hazards, n, sizeof(void *), cq_ptr_cmp))
+            h->retired[kept++] = node;
+        else
+            free(node);
+    }
+    h->nretired = kept;
+    free(hazards);
+}
+
+/* Defer freeing a node unlinked from the queue until no thread reads it */
+static void cq_retire(cq_handle_t *h, cq_node_t *node)
+{
+    while (h->nretired == h->retired_capacity) {
+        size_t capacity =
+            h->retired_capacity ? 2 * h->retired_capacity : CQ_RETIRE_MIN;
+        cq_node_t **retired =
+            realloc(h->retired, capacity * sizeof(cq_node_t *));
+        if (retired) {
+            h->retired = retired;
+            h->retired_capacity = capacity;
+            break;
+        }
+        /* Hazard pointers are short-lived: wait for some to go away */
+        cq_scan(h);
+        sched_yield();
+    }
+    h->retired[h->nretired++] = node;
+
+    size_t threshold = (size_t) atomic_load(&h->q->nhandles) * CQ_HAZARDS * 2;
+    if (threshold < CQ_RETIRE_MIN)
+        threshold = CQ_RETIRE_MIN;
+    if (h->nretired >= threshold)
+        cq_scan(h);
+}
+
+void cq_detach(cq_handle_t *h)
+{
+    if (!h)
+        return;
+    for (int i = 0; i < CQ_HAZARDS; i++)
+        atomic_store(&h->hazard[i], NULL);
+    cq_scan(h);
+    atomic_store(&h->active, false);
+}
+
+/* Publish a hazard pointer to the node src points to.
+ * The node is protected once src is seen unchanged after publishing.
+ */
+static cq_node_t *cq_protect(cq_handle_t *h,
+                             int i,
+                             _Atomic(cq_node_t *) *src)
+{
+    cq_node_t *node = atomic_load(src);
+    for (;;) {
+        atomic_store(&h->hazard[i], node);
+        cq_node_t *again = atomic_load(src);
+        if (again == node)
+            return node;
+        node = again;
+    }
+}
+
+bool cq_insert_tail(cq_handle_t *h, void *value)
+{
+    if (!h || !value)
+        return false;
+
+    cq_node_t *node = cq_new_node(value);
+    if (!node)
+        return false;
+
+    cq_t *q = h->q;
+    for (;;) {
+        cq_node_t *tail = cq_protect(h, 0, &q->tail);
+        cq_node_t *next = atomic_load(&tail->next);
+        if (tail != atomic_load(&q->tail))
+            continue;
+        if (next) {
+            /* Help a lagging insertion move the tail forward */
+            atomic_compare_exchange_strong(&q->tail, &tail, next);
+            continue;
+        }
+        cq_node_t *expected = NULL;
+        if (atomic_compare_exchange_strong(&tail->next, &expected, node)) {
+            atomic_compare_exchange_strong(&q->tail, &tail, node);
+            break;
+        }
+    }
+    atomic_store(&h->hazard[0], NULL);
+    return true;
+}
+
+void *cq_remove_head(cq_handle_t *h)
+{
+    if (!h)
+        return NULL;
+
+    cq_t *q = h->q;
+    cq_node_t *head;
+    void *value;
+    for (;;) {
+        head = cq_protect(h, 0, &q->head);
+        cq_node_t *tail = atomic_load(&q->tail);
+        cq_node_t *next = atomic_load(&head->next);
+        atomic_store(&h->hazard[1], next);
+        if (head != atomic_load(&q->head))
+            continue;
+        if (!next) {
+            atomic_store(&h->hazard[0], NULL);
+            return NULL;
+        }
+        if (head == tail) {
+            atomic_compare_exchange_strong(&q->tail, &tail, next);
+            continue;
+        }
+        /* next stays reachable while head is unchanged, so reading its value
+         * before the exchange is safe; only the winner returns it.
+         */
+        value = next->value;
+        if (atomic_compare_exchange_strong(&q->head, &head, next))
+            break;
+    }
+    atomic_store(&h->hazard[0], NULL);
+    atomic_store(&h->hazard[1], NULL);
+    cq_retire(h, head);
+    return value;
+}
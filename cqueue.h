@@ -0,0 +1,80 @@
+#ifndef LAB0_CQUEUE_H
+#define LAB0_CQUEUE_H
+
+/* Concurrent queue for multi-producer, multi-consumer ingestion
+ *
+ * A lock-free linked queue after Michael and Scott, "Simple, Fast, and
+ * Practical Non-Blocking and Blocking Concurrent Queue Algorithms" (PODC
+ * 1996).  Nodes unlinked by a consumer may still be read by other threads,
+ * so they are reclaimed with hazard pointers (Michael, "Hazard Pointers: Safe
+ * Memory Reclamation for Lock-Free Objects", IEEE TPDS 2004).
+ *
+ * The queue stores opaque non-NULL pointers and never dereferences them;
+ * ownership of whatever they point to passes from producer to consumer.
+ * Nodes are allocated with the C library directly rather than through the
+ * test harness, which has no aligned_alloc() to offer.
+ */
+
+#include <stdbool.h>
+
+typedef struct cq cq_t;
+
+/* Per-thread access to a queue, holding its hazard pointers and the nodes it
+ * retired but could not free yet.
+ */
+typedef struct cq_handle cq_handle_t;
+
+/**
+ * cq_new() - Create an empty concurrent queue
+ *
+ * Return: NULL for allocation failed
+ */
+cq_t *cq_new(void);
+
+/**
+ * cq_free() - Free all storage used by a concurrent queue
+ * @q: queue to free
+ *
+ * Values still in the queue are dropped without being touched.  No thread may
+ * use the queue or any of its handles any more.
+ */
+void cq_free(cq_t *q);
+
+/**
+ * cq_attach() - Get a handle through which the calling thread uses a queue
+ * @q: queue to use
+ *
+ * Handles released with cq_detach() are reused before new ones are allocated.
+ *
+ * Return: NULL for allocation failed
+ */
+cq_handle_t *cq_attach(cq_t *q);
+
+/**
+ * cq_detach() - Give up a handle obtained with cq_attach()
+ * @h: handle to release
+ */
+void cq_detach(cq_handle_t *h);
+
+/**
+ * cq_insert_tail() - Append a value to the queue
+ * @h: handle of the calling thread
+ * @value: non-NULL pointer to store
+ *
+ * Lock-free: a stalled thread never prevents others from making progress.
+ *
+ * Return: true for success, false for allocation failed or value is NULL
+ */
+bool cq_insert_tail(cq_handle_t *h, void *value);
+
+/**
+ * cq_remove_head() - Take the oldest value out of the queue
+ * @h: handle of the calling thread
+ *
+ * Values inserted by one producer are removed in the order it inserted them.
+ *
+ * Return: the value, NULL if the queue is empty
+ */
+void *cq_remove_head(cq_handle_t *h);
+
+#endif /* LAB0_CQUEUE_H */
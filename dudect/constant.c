@@ -39,12 +39,20 @@ static struct list_head *l = NULL;
 static char random_string[N_MEASURES][8];
 static int random_string_iter = 0;
 
+/* Number of elements removed at once by remove_head_n and remove_tail_n */
+static int batch_size = 16;
+
 /* Implement the necessary queue interface to simulation */
 void init_dut(void)
 {
     l = NULL;
 }
 
+void dut_set_batch(int n)
+{
+    batch_size = n;
+}
+
 static char *get_random_string(void)
 {
     random_string_iter = (random_string_iter + 1) % N_MEASURES;
@@ -73,7 +81,8 @@ bool measure(int64_t *before_ticks,
              int mode)
 {
     assert(mode == DUT(insert_head) || mode == DUT(insert_tail) ||
-           mode == DUT(remove_head) || mode == DUT(remove_tail));
+           mode == DUT(remove_head) || mode == DUT(remove_tail) ||
+           mode == DUT(remove_head_n) || mode == DUT(remove_tail_n));
 
     switch (mode) {
     case DUT(insert_head):
@@ -146,6 +155,31 @@ bool measure(int64_t *before_ticks,
                 return false;
         }
         break;
+    case DUT(remove_head_n):
+    case DUT(remove_tail_n):
+        for (size_t i = DROP_SIZE; i < N_MEASURES - DROP_SIZE; i++) {
+            LIST_HEAD(removed);
+            dut_new();
+            /* Keep more than one batch, so the whole queue is never taken */
+            dut_insert_head(
+                get_random_string(),
+                *(uint16_t *) (input_data + i * CHUNK_SIZE) % 10000 +
+                    batch_size + 1);
+            int before_size = q_size(l);
+            before_ticks[i] = cpucycles();
+            int cnt = mode == DUT(remove_head_n)
+                          ? q_remove_head_n(l, &removed, batch_size)
+                          : q_remove_tail_n(l, &removed, batch_size);
+            after_ticks[i] = cpucycles();
+            int after_size = q_size(l);
+            element_t *e, *tmp;
+            list_for_each_entry_safe (e, tmp, &removed, list)
+                q_release_element(e);
+            dut_free();
+            if (cnt != batch_size || before_size != after_size + cnt)
+                return false;
+        }
+        break;
     default:
         for (size_t i = DROP_SIZE; i < N_MEASURES - DROP_SIZE; i++) {
             dut_new();
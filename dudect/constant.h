@@ -12,11 +12,13 @@
 
 #define DROP_SIZE 20
 
-#define DUT_FUNCS  \
-    _(insert_head) \
-    _(insert_tail) \
-    _(remove_head) \
-    _(remove_tail)
+#define DUT_FUNCS    \
+    _(insert_head)   \
+    _(insert_tail)   \
+    _(remove_head)   \
+    _(remove_tail)   \
+    _(remove_head_n) \
+    _(remove_tail_n)
 
 #define DUT(x) DUT_##x
 
@@ -27,6 +29,7 @@ enum {
 };
 
 void init_dut();
+void dut_set_batch(int n);
 void prepare_inputs(uint8_t *input_data, uint8_t *classes);
 bool measure(int64_t *before_ticks,
              int64_t *after_ticks,
@@ -1,10 +1,14 @@
 /* Test support code */
 
+#include <pthread.h>
 #include <setjmp.h>
 #include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include "report.h"
@@ -18,6 +22,9 @@
 /* Value at start of every allocated block */
 #define MAGICHEADER 0xdeadbeef
 
+/* Value at start of every block placed against a guard page */
+#define MAGICGUARD 0xdeadf00d
+
 /* Value when deallocate block */
 #define MAGICFREE 0xffffffff
 
@@ -29,26 +36,76 @@
 
 /* Data structures used by our code */
 
-/* Represent allocated blocks as doubly-linked list, with
- * next and prev pointers at beginning
- */
+/* Header placed in front of every allocated block */
 typedef struct __block_element {
-    struct __block_element *next, *prev;
     size_t payload_size;
     size_t magic_header; /* Marker to see if block seems legitimate */
     unsigned char payload[0];
     /* Also place magic number at tail of every block */
 } block_element_t;
 
-static block_element_t *allocated = NULL;
-static size_t allocated_count = 0;
+/* Live blocks are kept in open-addressing hash sets, so that cautious mode
+ * can validate a block in constant time rather than by scanning every
+ * allocation.  Linear probing with backward-shift deletion keeps the tables
+ * free of tombstones.  Capacities are always powers of two.
+ *
+ * The blocks are spread over shards, each with a lock of its own, so that
+ * threads allocating and freeing concurrently rarely wait for each other.
+ * A block is assigned to a shard by its address rather than by the thread
+ * allocating it, since it may well be freed by another thread.  Neighbouring
+ * blocks share a shard, which keeps single-threaded use cache friendly.
+ */
+#define LIVE_MIN_CAPACITY 64
+#define LIVE_SHARDS 64
+#define LIVE_SHARD_SHIFT 14
+
+typedef struct {
+    pthread_mutex_t lock;
+    block_element_t **blocks;
+    size_t capacity, count;
+    size_t bytes; /* Payload bytes of the blocks in this shard */
+} live_shard_t;
+
+static live_shard_t live_shards[LIVE_SHARDS] = {
+    [0 ... LIVE_SHARDS - 1] = {.lock = PTHREAD_MUTEX_INITIALIZER},
+};
+
+/* The allocation profile counts blocks by size class, by the command that
+ * allocated them, and the peak of live blocks and bytes.  Class c holds the
+ * sizes up to 2^c bytes; the last one holds everything larger.  Commands are
+ * told apart by the address of their name, which must stay valid.
+ */
+#define PROFILE_CLASSES 21
+#define PROFILE_COMMANDS 64
+
+typedef struct {
+    const char *name;
+    atomic_size_t mallocs, frees, bytes;
+} profile_cmd_t;
+
+static atomic_bool profile_enabled = false;
+static atomic_size_t profile_classes[PROFILE_CLASSES];
+static atomic_size_t live_blocks, live_bytes, peak_blocks, peak_bytes;
+static profile_cmd_t profile_cmds[PROFILE_COMMANDS] = {{.name = "(none)"}};
+static int profile_ncmds = 1;
+static atomic_int profile_current = 0;
 
 /* Percent probability of malloc failure */
 int fail_probability = 0;
 
+/* Payload poisoning: 0 fills every block, 1 leaves payloads alone and keeps
+ * only the header and footer canaries, N > 1 fills one block in N.
+ */
+int poison_mode = 0;
+static _Thread_local unsigned poison_tick;
+
+/* Guard pages: 0 places no block against one, N places one block in N */
+int guard_mode = 0;
+static _Thread_local unsigned guard_tick;
+
 static bool cautious_mode = true;
 static bool noallocate_mode = false;
-static bool error_occurred = false;
+static atomic_bool error_occurred = false;
 static char *error_message = "";
 
 static int time_limit = 1;
@@ -67,6 +124,199 @@ static bool fail_allocation()
     return (weight < 0.01 * fail_probability);
 }
 
+static inline live_shard_t *live_shard(const block_element_t *b)
+{
+    uintptr_t x = (uintptr_t) b >> LIVE_SHARD_SHIFT;
+    return &live_shards[(x ^ (x >> 6)) & (LIVE_SHARDS - 1)];
+}
+
+static inline size_t live_slot(const live_shard_t *shard,
+                               const block_element_t *b)
+{
+    uintptr_t x = (uintptr_t) b >> 4;
+    return (size_t) (x ^ (x >> 12)) & (shard->capacity - 1);
+}
+
+/* Return the slot holding b, or the empty slot where b would be inserted */
+static size_t live_lookup(const live_shard_t *shard, const block_element_t *b)
+{
+    size_t i = live_slot(shard, b);
+    while (shard->blocks[i] && shard->blocks[i] != b)
+        i = (i + 1) & (shard->capacity - 1);
+    return i;
+}
+
+static bool live_grow(live_shard_t *shard)
+{
+    size_t old_capacity = shard->capacity;
+    block_element_t **old_blocks = shard->blocks;
+
+    shard->capacity = old_capacity ? old_capacity * 2 : LIVE_MIN_CAPACITY;
+    shard->blocks = calloc(shard->capacity, sizeof(block_element_t *));
+    if (!shard->blocks) {
+        shard->blocks = old_blocks;
+        shard->capacity = old_capacity;
+        return false;
+    }
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_blocks[i])
+            shard->blocks[live_lookup(shard, old_blocks[i])] = old_blocks[i];
+    }
+    free(old_blocks);
+    return true;
+}
+
+static bool live_insert(block_element_t *b)
+{
+    live_shard_t *shard = live_shard(b);
+    bool ok = true;
+
+    pthread_mutex_lock(&shard->lock);
+    /* Keep the load factor at or below one half */
+    if (2 * (shard->count + 1) > shard->capacity && !live_grow(shard)) {
+        ok = false;
+    } else {
+        shard->blocks[live_lookup(shard, b)] = b;
+        shard->count++;
+        shard->bytes += b->payload_size;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return ok;
+}
+
+static bool live_contains(const block_element_t *b)
+{
+    live_shard_t *shard = live_shard(b);
+
+    pthread_mutex_lock(&shard->lock);
+    bool found =
+        shard->capacity && shard->blocks[live_lookup(shard, b)] == b;
+    pthread_mutex_unlock(&shard->lock);
+    return found;
+}
+
+/* Account for a live block whose payload changed size in place */
+static void live_resize(const block_element_t *b, size_t old_size)
+{
+    live_shard_t *shard = live_shard(b);
+
+    pthread_mutex_lock(&shard->lock);
+    shard->bytes += b->payload_size - old_size;
+    pthread_mutex_unlock(&shard->lock);
+}
+
+static void live_remove(const block_element_t *b)
+{
+    live_shard_t *shard = live_shard(b);
+
+    pthread_mutex_lock(&shard->lock);
+    size_t mask = shard->capacity - 1;
+    size_t hole = shard->capacity ? live_lookup(shard, b) : 0;
+    if (!shard->capacity || !shard->blocks[hole]) {
+        pthread_mutex_unlock(&shard->lock);
+        return;
+    }
+
+    /* Shift back any entry whose probe sequence passes through the hole */
+    block_element_t **blocks = shard->blocks;
+    blocks[hole] = NULL;
+    for (size_t i = (hole + 1) & mask; blocks[i]; i = (i + 1) & mask) {
+        size_t home = live_slot(shard, blocks[i]);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            blocks[hole] = blocks[i];
+            blocks[i] = NULL;
+            hole = i;
+        }
+    }
+    shard->count--;
+    shard->bytes -= b->payload_size;
+    pthread_mutex_unlock(&shard->lock);
+}
+
+static void profile_max(atomic_size_t *peak, size_t value)
+{
+    size_t old = atomic_load_explicit(peak, memory_order_relaxed);
+    while (old < value && !atomic_compare_exchange_weak(peak, &old, value))
+        ;
+}
+
+static void profile_malloc(size_t size)
+{
+    int c = 0;
+    while (c < PROFILE_CLASSES - 1 && ((size_t) 1 << c) < size)
+        c++;
+    atomic_fetch_add_explicit(&profile_classes[c], 1, memory_order_relaxed);
+
+    profile_cmd_t *cmd = &profile_cmds[atomic_load(&profile_current)];
+    atomic_fetch_add_explicit(&cmd->mallocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&cmd->bytes, size, memory_order_relaxed);
+
+    profile_max(&peak_blocks, atomic_fetch_add(&live_blocks, 1) + 1);
+    profile_max(&peak_bytes, atomic_fetch_add(&live_bytes, size) + size);
+}
+
+static void profile_free(size_t size)
+{
+    profile_cmd_t *cmd = &profile_cmds[atomic_load(&profile_current)];
+    atomic_fetch_add_explicit(&cmd->frees, 1, memory_order_relaxed);
+    atomic_fetch_sub(&live_blocks, 1);
+    atomic_fetch_sub(&live_bytes, size);
+}
+
+/* Whether to fill the payload of the block being allocated or freed */
+static bool poison_payload()
+{
+    int mode = poison_mode;
+    if (mode <= 0)
+        return true;
+    if (mode == 1)
+        return false;
+    return ++poison_tick % (unsigned) mode == 0;
+}
+
+/* Guarded blocks end, footer included, on the 16-byte boundary where an
+ * inaccessible page starts, so that an overrun past the footer faults at
+ * once.  Shorter overruns still show up in the footer.  The mapping holds
+ * nothing else and goes away when the block is freed.
+ */
+#define GUARD_ALIGN 16
+
+static size_t guard_span(size_t size)
+{
+    size_t total = size + sizeof(block_element_t) + sizeof(size_t);
+    return (total + GUARD_ALIGN - 1) & ~(size_t) (GUARD_ALIGN - 1);
+}
+
+static block_element_t *guard_alloc(size_t size)
+{
+    int mode = guard_mode;
+    if (mode <= 0 || ++guard_tick % (unsigned) mode)
+        return NULL;
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t span = guard_span(size);
+    size_t len = (span + page - 1) & ~(page - 1);
+    unsigned char *region = mmap(NULL, len + page, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+        return NULL;
+    /* Out of mappings, say: fall back to an unguarded block */
+    if (mprotect(region + len, page, PROT_NONE)) {
+        munmap(region, len + page);
+        return NULL;
+    }
+    return (block_element_t *) (region + len - span);
+}
+
+static void guard_free(block_element_t *b)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    uintptr_t guard = (uintptr_t) b + guard_span(b->payload_size);
+    uintptr_t region = (uintptr_t) b & ~(page - 1);
+    munmap((void *) region, guard + page - region);
+}
+
 /* Find header of block, given its payload.
  * Signal error if doesn't seem like legitimate block
  */
@@ -81,13 +331,7 @@ static block_element_t *find_header(void *p)
         (block_element_t *) ((size_t) p - sizeof(block_element_t));
     if (cautious_mode) {
         /* Make sure this is really an allocated block */
-        block_element_t *ab = allocated;
-        bool found = false;
-        while (ab && !found) {
-            found = ab == b;
-            ab = ab->next;
-        }
-        if (!found) {
+        if (!live_contains(b)) {
             report_event(MSG_ERROR,
                          "Attempted to free unallocated block.  Address = %p",
                          p);
@@ -95,7 +339,7 @@ static block_element_t *find_header(void *p)
         }
     }
 
-    if (b->magic_header != MAGICHEADER) {
+    if (b->magic_header != MAGICHEADER && b->magic_header != MAGICGUARD) {
         report_event(
             MSG_ERROR,
             "Attempted to free unallocated or corrupted block.  Address = %p",
@@ -129,29 +373,32 @@ void *test_malloc(size_t size)
         return NULL;
     }
 
-    block_element_t *new_block =
-        malloc(size + sizeof(block_element_t) + sizeof(size_t));
+    size_t magic = MAGICGUARD;
+    block_element_t *new_block = guard_alloc(size);
+    if (!new_block) {
+        magic = MAGICHEADER;
+        new_block = malloc(size + sizeof(block_element_t) + sizeof(size_t));
+    }
     if (!new_block) {
         report_event(MSG_FATAL, "Couldn't allocate any more memory");
         error_occurred = true;
     }
 
     // cppcheck-suppress nullPointerRedundantCheck
-    new_block->magic_header = MAGICHEADER;
+    new_block->magic_header = magic;
     // cppcheck-suppress nullPointerRedundantCheck
     new_block->payload_size = size;
     *find_footer(new_block) = MAGICFOOTER;
     void *p = (void *) &new_block->payload;
-    memset(p, FILLCHAR, size);
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->next = allocated;
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->prev = NULL;
+    if (poison_payload())
+        memset(p, FILLCHAR, size);
 
-    if (allocated)
-        allocated->prev = new_block;
-    allocated = new_block;
-    allocated_count++;
+    if (!live_insert(new_block)) {
+        report_event(MSG_FATAL, "Couldn't track any more allocated blocks");
+        error_occurred = true;
+    } else if (atomic_load_explicit(&profile_enabled, memory_order_relaxed)) {
+        profile_malloc(size);
+    }
 
     return p;
 }
@@ -187,22 +434,110 @@ void test_free(void *p)
                      p);
         error_occurred = true;
     }
+    bool guarded = b->magic_header == MAGICGUARD;
     b->magic_header = MAGICFREE;
     *find_footer(b) = MAGICFREE;
-    memset(p, FILLCHAR, b->payload_size);
-
-    /* Unlink from list */
-    block_element_t *bn = b->next;
-    block_element_t *bp = b->prev;
-    if (bp)
-        bp->next = bn;
+    if (poison_payload())
+        memset(p, FILLCHAR, b->payload_size);
+
+    if (atomic_load_explicit(&profile_enabled, memory_order_relaxed))
+        profile_free(b->payload_size);
+    live_remove(b);
+    if (guarded)
+        guard_free(b);
     else
-        allocated = bn;
-    if (bn)
-        bn->prev = bp;
+        free(b);
+}
+
+/* Resize a block, keeping its contents up to the smaller of the two sizes.
+ * Shrinking happens in place.  Growing goes through realloc, which may
+ * extend the block in place; the harness holds no other reference to it.
+ * Blocks against a guard page always move.  On failure the original block is
+ * left untouched.
+ */
+// cppcheck-suppress unusedFunction
+void *test_realloc(void *p, size_t size)
+{
+    if (!p)
+        return test_malloc(size);
+
+    if (!size) {
+        test_free(p);
+        return NULL;
+    }
+
+    if (noallocate_mode) {
+        report_event(MSG_FATAL, "Calls to realloc disallowed");
+        return NULL;
+    }
+
+    block_element_t *b = find_header(p);
+    if (*find_footer(b) != MAGICFOOTER) {
+        report_event(MSG_ERROR,
+                     "Corruption detected in block with address %p when "
+                     "attempting to realloc it",
+                     p);
+        error_occurred = true;
+    }
+
+    /* A guarded block must keep ending at its guard page, so it moves */
+    size_t old_size = b->payload_size;
+    if (b->magic_header == MAGICGUARD) {
+        void *q = test_malloc(size);
+        if (q) {
+            memcpy(q, p, size < old_size ? size : old_size);
+            test_free(p);
+        }
+        return q;
+    }
+
+    if (size <= old_size) {
+        if (poison_payload())
+            memset((unsigned char *) p + size, FILLCHAR, old_size - size);
+        b->payload_size = size;
+        *find_footer(b) = MAGICFOOTER;
+        live_resize(b, old_size);
+        if (atomic_load_explicit(&profile_enabled, memory_order_relaxed)) {
+            profile_free(old_size);
+            profile_malloc(size);
+        }
+        return p;
+    }
+
+    if (fail_allocation()) {
+        report_event(MSG_WARN, "Realloc returning NULL");
+        return NULL;
+    }
+
+    /* The block may move, so it leaves the live set until it settles */
+    live_remove(b);
+    block_element_t *new_block =
+        realloc(b, size + sizeof(block_element_t) + sizeof(size_t));
+    if (!new_block) {
+        if (!live_insert(b)) {
+            report_event(MSG_FATAL,
+                         "Couldn't track any more allocated blocks");
+            error_occurred = true;
+        }
+        report_event(MSG_WARN, "Realloc returning NULL");
+        return NULL;
+    }
 
-    free(b);
-    allocated_count--;
+    new_block->payload_size = size;
+    *find_footer(new_block) = MAGICFOOTER;
+    p = (void *) &new_block->payload;
+    if (poison_payload())
+        memset((unsigned char *) p + old_size, FILLCHAR, size - old_size);
+
+    if (!live_insert(new_block)) {
+        report_event(MSG_FATAL, "Couldn't track any more allocated blocks");
+        error_occurred = true;
+    } else if (atomic_load_explicit(&profile_enabled, memory_order_relaxed)) {
+        profile_free(old_size);
+        profile_malloc(size);
+    }
+
+    return p;
 }
 
 // cppcheck-suppress unusedFunction
@@ -218,7 +553,13 @@ char *test_strdup(const char *s)
 
 size_t allocation_check()
 {
-    return allocated_count;
+    size_t count = 0;
+    for (int i = 0; i < LIVE_SHARDS; i++) {
+        pthread_mutex_lock(&live_shards[i].lock);
+        count += live_shards[i].count;
+        pthread_mutex_unlock(&live_shards[i].lock);
+    }
+    return count;
 }
 
 /* Implementation of functions for testing */
@@ -239,12 +580,89 @@ void set_noallocate_mode(bool noallocate)
     noallocate_mode = noallocate;
 }
 
+/* Turn allocation profiling on or off, clearing what was recorded so far.
+ * Blocks already live count toward the peaks, but not toward any command.
+ */
+void set_alloc_profile(bool enable)
+{
+    atomic_store(&profile_enabled, false);
+    for (int c = 0; c < PROFILE_CLASSES; c++)
+        atomic_store(&profile_classes[c], 0);
+    for (int i = 0; i < profile_ncmds; i++) {
+        atomic_store(&profile_cmds[i].mallocs, 0);
+        atomic_store(&profile_cmds[i].frees, 0);
+        atomic_store(&profile_cmds[i].bytes, 0);
+    }
+
+    size_t blocks = 0, bytes = 0;
+    for (int i = 0; i < LIVE_SHARDS; i++) {
+        pthread_mutex_lock(&live_shards[i].lock);
+        blocks += live_shards[i].count;
+        bytes += live_shards[i].bytes;
+        pthread_mutex_unlock(&live_shards[i].lock);
+    }
+    atomic_store(&live_blocks, blocks);
+    atomic_store(&live_bytes, bytes);
+    atomic_store(&peak_blocks, blocks);
+    atomic_store(&peak_bytes, bytes);
+    atomic_store(&profile_enabled, enable);
+}
+
+/* Charge the allocations that follow to the named command */
+void alloc_profile_command(const char *name)
+{
+    int i = 0;
+    while (i < profile_ncmds && profile_cmds[i].name != name)
+        i++;
+    if (i == profile_ncmds) {
+        if (profile_ncmds == PROFILE_COMMANDS)
+            i = 0;
+        else
+            profile_cmds[profile_ncmds++].name = name;
+    }
+    atomic_store(&profile_current, i);
+}
+
+/* Report the allocation profile recorded since profiling was turned on */
+void alloc_profile_report()
+{
+    if (!atomic_load(&profile_enabled)) {
+        report(1, "Allocation profiling is off.  Use 'option profile 1'");
+        return;
+    }
+
+    report(1, "Live: %zu blocks, %zu bytes.  Peak: %zu blocks, %zu bytes",
+           atomic_load(&live_blocks), atomic_load(&live_bytes),
+           atomic_load(&peak_blocks), atomic_load(&peak_bytes));
+
+    report(1, "%-12s %12s", "Size", "Mallocs");
+    for (int c = 0; c < PROFILE_CLASSES; c++) {
+        size_t n = atomic_load(&profile_classes[c]);
+        if (!n)
+            continue;
+        char range[32];
+        if (c == PROFILE_CLASSES - 1)
+            snprintf(range, sizeof(range), "> %zu", (size_t) 1 << (c - 1));
+        else
+            snprintf(range, sizeof(range), "<= %zu", (size_t) 1 << c);
+        report(1, "%-12s %12zu", range, n);
+    }
+
+    report(1, "%-12s %12s %12s %12s", "Command", "Mallocs", "Bytes", "Frees");
+    for (int i = 0; i < profile_ncmds; i++) {
+        profile_cmd_t *cmd = &profile_cmds[i];
+        size_t mallocs = atomic_load(&cmd->mallocs);
+        size_t frees = atomic_load(&cmd->frees);
+        if (mallocs || frees)
+            report(1, "%-12s %12zu %12zu %12zu", cmd->name, mallocs,
+                   atomic_load(&cmd->bytes), frees);
+    }
+}
+
 /* Return whether any errors have occurred since last time set error limit */
 bool error_check()
 {
-    bool e = error_occurred;
-    error_occurred = false;
-    return e;
+    return atomic_exchange(&error_occurred, false);
 }
 
 /* Prepare for a risky operation using setjmp.
@@ -7,14 +7,15 @@
 
 /* This test harness enables us to do stringent testing of code.
  * It overloads the library versions of malloc and free with ones that
- * allow checking for common allocation errors.
+ * allow checking for common allocation errors.  They may be called from
+ * any thread, and a block may be freed by a thread other than its allocator.
  */
 
 void *test_malloc(size_t size);
 void *test_calloc(size_t nmemb, size_t size);
 void test_free(void *p);
 char *test_strdup(const char *s);
-/* FIXME: provide test_realloc as well */
+void *test_realloc(void *p, size_t size);
 
 #ifdef INTERNAL
 
@@ -24,6 +25,18 @@ size_t allocation_check();
 /* Probability of malloc failing, expressed as percent */
 extern int fail_probability;
 
+/*
+ * How payloads are filled on malloc and free: 0 fills every block, 1 keeps
+ * only the header and footer canaries, N > 1 fills one block in N.
+ */
+extern int poison_mode;
+
+/*
+ * How often a block is placed against an inaccessible page, so that writing
+ * past its end faults at once: 0 never, N for one block in N.
+ */
+extern int guard_mode;
+
 /*
  * Set/unset cautious mode.
  * In this mode, makes extra sure any block to be freed is currently allocated.
@@ -36,6 +49,19 @@ void set_cautious_mode(bool cautious);
  */
 void set_noallocate_mode(bool noallocate);
 
+/*
+ * Turn allocation profiling on or off, clearing the profile.
+ * The profile counts allocations by size class and by command, and records
+ * the peak number of live blocks and bytes.
+ */
+void set_alloc_profile(bool enable);
+
+/* Charge subsequent allocations to a command, whose name must stay valid */
+void alloc_profile_command(const char *name);
+
+/* Report the allocation profile */
+void alloc_profile_report();
+
 /* Return whether any errors have occurred since last time checked */
 bool error_check();
 
@@ -56,6 +82,7 @@ void trigger_exception(char *msg);
 /* Tested program use our versions of malloc and free */
 #define malloc test_malloc
 #define free test_free
+#define realloc test_realloc
 
 /* Use undef to avoid strdup redefined error */
 #undef strdup
@@ -0,0 +1,141 @@
+/* Two-lock deque of queue elements */
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "lqueue.h"
+
+/* While fewer elements than this are counted, an operation at one end may
+ * touch the nodes an operation at the other end touches, so it takes both
+ * locks.  From three elements on, the two ends only share the sentinel,
+ * whose next and prev are each written from a single end.
+ */
+#define LQ_SHARED_BELOW 3
+
+/* @size never exceeds the number of elements linked and not being removed:
+ * insertions count an element once it is linked, removals uncount it before
+ * unlinking it.  A single-lock operation may thus trust what it reads.
+ */
+struct lq {
+    struct list_head head;
+    atomic_int size;
+    bool global;
+    pthread_mutex_t head_lock;
+    char pad[64]; /* Keep the two locks on different cache lines */
+    pthread_mutex_t tail_lock;
+};
+
+lq_t *lq_new(bool global_lock)
+{
+    lq_t *q = malloc(sizeof(lq_t));
+    if (!q)
+        return NULL;
+
+    INIT_LIST_HEAD(&q->head);
+    atomic_init(&q->size, 0);
+    q->global = global_lock;
+    pthread_mutex_init(&q->head_lock, NULL);
+    pthread_mutex_init(&q->tail_lock, NULL);
+    return q;
+}
+
+void lq_free(lq_t *q)
+{
+    if (!q)
+        return;
+
+    element_t *e, *tmp;
+    list_for_each_entry_safe (e, tmp, &q->head, list)
+        q_release_element(e);
+    pthread_mutex_destroy(&q->head_lock);
+    pthread_mutex_destroy(&q->tail_lock);
+    free(q);
+}
+
+/* Take the lock of one end, plus the other one when the deque is short.
+ * Locks are always acquired head first.  Return whether both are held.
+ */
+static bool lq_lock(lq_t *q, bool at_head)
+{
+    if (q->global) {
+        pthread_mutex_lock(&q->head_lock);
+        return false;
+    }
+
+    if (at_head) {
+        pthread_mutex_lock(&q->head_lock);
+        if (atomic_load(&q->size) >= LQ_SHARED_BELOW)
+            return false;
+        pthread_mutex_lock(&q->tail_lock);
+        return true;
+    }
+
+    pthread_mutex_lock(&q->tail_lock);
+    if (atomic_load(&q->size) >= LQ_SHARED_BELOW)
+        return false;
+    pthread_mutex_unlock(&q->tail_lock);
+    pthread_mutex_lock(&q->head_lock);
+    pthread_mutex_lock(&q->tail_lock);
+    return true;
+}
+
+static void lq_unlock(lq_t *q, bool at_head, bool both)
+{
+    if (q->global || (at_head && !both)) {
+        pthread_mutex_unlock(&q->head_lock);
+        return;
+    }
+    pthread_mutex_unlock(&q->tail_lock);
+    if (both)
+        pthread_mutex_unlock(&q->head_lock);
+}
+
+static void lq_insert(lq_t *q, element_t *e, bool at_head)
+{
+    bool both = lq_lock(q, at_head);
+    if (at_head)
+        list_add(&e->list, &q->head);
+    else
+        list_add_tail(&e->list, &q->head);
+    atomic_fetch_add(&q->size, 1);
+    lq_unlock(q, at_head, both);
+}
+
+static element_t *lq_remove(lq_t *q, bool at_head)
+{
+    bool both = lq_lock(q, at_head);
+    element_t *e = NULL;
+    if (atomic_load(&q->size) > 0) {
+        atomic_fetch_sub(&q->size, 1);
+        e = at_head ? list_first_entry(&q->head, element_t, list)
+                    : list_last_entry(&q->head, element_t, list);
+        list_del(&e->list);
+    }
+    lq_unlock(q, at_head, both);
+    return e;
+}
+
+void lq_insert_head(lq_t *q, element_t *e)
+{
+    lq_insert(q, e, true);
+}
+
+void lq_insert_tail(lq_t *q, element_t *e)
+{
+    lq_insert(q, e, false);
+}
+
+element_t *lq_remove_head(lq_t *q)
+{
+    return lq_remove(q, true);
+}
+
+element_t *lq_remove_tail(lq_t *q)
+{
+    return lq_remove(q, false);
+}
+
+int lq_size(lq_t *q)
+{
+    return atomic_load(&q->size);
+}
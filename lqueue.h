@@ -0,0 +1,75 @@
+#ifndef LAB0_LQUEUE_H
+#define LAB0_LQUEUE_H
+
+/* Thread-safe deque of queue elements with one lock per end
+ *
+ * The elements are the element_t of queue.h, linked through their list
+ * member into a circular doubly-linked list, and are released with
+ * q_release_element().  Operations at the head take the head lock and
+ * operations at the tail the tail lock, so a producer at one end does not
+ * wait for a consumer at the other.  Only when the deque is short enough for
+ * both ends to reach the same nodes does an operation take both locks.
+ *
+ * The deque links and unlinks elements but never allocates or frees them;
+ * the threads using it may do so themselves through the test harness.
+ */
+
+#include <stdbool.h>
+
+#include "queue.h"
+
+typedef struct lq lq_t;
+
+/**
+ * lq_new() - Create an empty deque
+ * @global_lock: serialize both ends through one mutex instead, for comparison
+ *
+ * Return: NULL for allocation failed
+ */
+lq_t *lq_new(bool global_lock);
+
+/**
+ * lq_free() - Free a deque and release the elements left in it
+ * @q: deque to free, no longer used by any thread
+ */
+void lq_free(lq_t *q);
+
+/**
+ * lq_insert_head() - Link an element at the head
+ * @q: deque
+ * @e: element not linked into any list
+ */
+void lq_insert_head(lq_t *q, element_t *e);
+
+/**
+ * lq_insert_tail() - Link an element at the tail
+ * @q: deque
+ * @e: element not linked into any list
+ */
+void lq_insert_tail(lq_t *q, element_t *e);
+
+/**
+ * lq_remove_head() - Unlink the element at the head
+ * @q: deque
+ *
+ * Return: the element, NULL if the deque is empty
+ */
+element_t *lq_remove_head(lq_t *q);
+
+/**
+ * lq_remove_tail() - Unlink the element at the tail
+ * @q: deque
+ *
+ * Return: the element, NULL if the deque is empty
+ */
+element_t *lq_remove_tail(lq_t *q);
+
+/**
+ * lq_size() - Get the number of elements, which may be changing meanwhile
+ * @q: deque
+ *
+ * Return: the number of elements
+ */
+int lq_size(lq_t *q);
+
+#endif /* LAB0_LQUEUE_H */
@@ -3,8 +3,11 @@
 #include <assert.h>
 #include <errno.h>
 #include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <spawn.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,6 +22,7 @@
 #include <time.h>
 #endif
 
+#include "cqueue.h"
 #include "dudect/fixture.h"
 #include "list.h"
 #include "random.h"
@@ -45,6 +49,7 @@ extern int show_entropy;
 #include "queue.h"
 
 #include "console.h"
+#include "lqueue.h"
 #include "report.h"
 
 /* Settable parameters */
@@ -53,7 +58,6 @@ extern int show_entropy;
 
 /* How large is a queue before it's considered big.
  * This affects how it gets printed
- * and whether cautious mode is used when freeing the queue
  */
 #define BIG_LIST_SIZE 30
 
@@ -75,8 +79,39 @@ static int string_length = MAXSTRING;
 
 static int descend = 0;
 
+/* Cross-check the element count cached by queue.c against a full walk */
+static int debug_mode = 0;
+
+/* Allocate elements of newly created queues from a per-queue pool */
+#ifdef QUEUE_UNROLLED
+static int pool_mode = 1;
+#else
+static int pool_mode = 0;
+#endif
+
+/* Order elements by their prefix keys before falling back to strcmp */
+static int prefix_mode = 1;
+
+/* Number of threads used by sort */
+static int sort_threads = 1;
+
+/* Sorting algorithm: 0 for merge sort, 1 for MSD radix sort */
+static int sort_algo = 0;
+
+/* Take the value pointer of removed elements instead of copying it */
+static int zerocopy_mode = 0;
+
+/* Create new queues as ring deques */
+static int ring_mode = 0;
+
+/* Record an allocation profile, shown by alloc_stats */
+static int profile_mode = 0;
+
 #define MIN_RANDSTR_LEN 5
 #define MAX_RANDSTR_LEN 10
+
+/* How many strings ih/it hand to the bulk insertion functions at once */
+#define INSERT_BATCH 1024
 static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
 /* For queue_insert and queue_remove */
 typedef enum {
@@ -86,6 +121,34 @@ typedef enum {
 /* Forward declarations */
 static bool q_show(int vlevel);
 
+/* Count the elements of a queue by walking it, independent of q_size() */
+static int q_walk_size(struct list_head *head)
+{
+    int len = 0;
+    struct list_head *li;
+
+    list_for_each (li, head)
+        len++;
+    return len;
+}
+
+/* In debug mode, make sure q_size() agrees with the actual list length */
+static bool q_check_size()
+{
+    if (!debug_mode || !current || !current->q)
+        return true;
+
+    int cached = q_size(current->q);
+    q_flatten(current->q);
+    int walked = q_walk_size(current->q);
+    if (cached != walked) {
+        report(1, "ERROR: q_size() returns %d, but queue holds %d elements",
+               cached, walked);
+        return false;
+    }
+    return true;
+}
+
 static bool do_free(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -101,9 +164,6 @@ static bool do_free(int argc, char *argv[])
     }
     error_check();
 
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
-
     struct list_head *qnext = NULL;
     if (chain.size > 1) {
         qnext = (current->chain.next == &chain.head) ? chain.head.next
@@ -116,7 +176,6 @@ static bool do_free(int argc, char *argv[])
         if (exception_setup(true))
             q_free(current->q);
         exception_cancel();
-        set_cautious_mode(true);
     }
 
     if (current) {
@@ -197,8 +256,8 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
         return ok;
     }
 
-    char *lasts = NULL;
-    char randstr_buf[MAX_RANDSTR_LEN];
+    char *strs[INSERT_BATCH];
+    static char randstr_buf[INSERT_BATCH][MAX_RANDSTR_LEN];
     int reps = 1;
     bool ok = true, need_rand = false;
     if (argc != 2 && argc != 3) {
@@ -214,10 +273,8 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
         }
     }
 
-    if (!strcmp(inserts, "RAND")) {
+    if (!strcmp(inserts, "RAND"))
         need_rand = true;
-        inserts = randstr_buf;
-    }
 
     if (!current || !current->q)
         report(3, "Warning: Calling insert %s on null queue",
@@ -225,46 +282,70 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
     error_check();
 
     if (current && exception_setup(true)) {
-        for (int r = 0; ok && r < reps; r++) {
-            if (need_rand)
-                fill_rand_string(randstr_buf, sizeof(randstr_buf));
-            bool rval = pos == POS_TAIL ? q_insert_tail(current->q, inserts)
-                                        : q_insert_head(current->q, inserts);
-            if (rval) {
-                current->size++;
-                element_t *entry =
-                    pos == POS_TAIL
-                        ? list_last_entry(current->q, element_t, list)
-                        : list_first_entry(current->q, element_t, list);
-                char *cur_inserts = entry->value;
+        for (int r = 0; ok && r < reps;) {
+            int batch = reps - r < INSERT_BATCH ? reps - r : INSERT_BATCH;
+            for (int i = 0; i < batch; i++) {
+                strs[i] = inserts;
+                if (need_rand) {
+                    fill_rand_string(randstr_buf[i], sizeof(randstr_buf[i]));
+                    strs[i] = randstr_buf[i];
+                }
+            }
+
+            /* A single string exercises the plain insertion functions */
+            int done;
+            if (batch == 1)
+                done = (pos == POS_TAIL ? q_insert_tail(current->q, strs[0])
+                                        : q_insert_head(current->q, strs[0]))
+                           ? 1
+                           : 0;
+            else
+                done = pos == POS_TAIL
+                           ? q_insert_tail_bulk(current->q, strs, batch)
+                           : q_insert_head_bulk(current->q, strs, batch);
+
+            if (done) {
+                current->size += done;
+                /* The element of the last string inserted is at the end of
+                 * the queue, next to the one of the string before it.
+                 * Peeking leaves ring queues in ring form.
+                 */
+                element_t *last_e =
+                    q_peek(current->q, pos == POS_TAIL ? -1 : 0);
+                element_t *prev_e =
+                    q_peek(current->q, pos == POS_TAIL ? -2 : 1);
+                char *cur_inserts = last_e ? last_e->value : NULL;
                 if (!cur_inserts) {
                     report(1, "ERROR: Failed to save copy of string in queue");
                     ok = false;
-                } else if (r == 0 && inserts == cur_inserts) {
+                } else if (cur_inserts == strs[done - 1]) {
                     report(1,
                            "ERROR: Need to allocate and copy string for new "
                            "queue element");
                     ok = false;
                     break;
-                } else if (r == 1 && lasts == cur_inserts) {
+                } else if (r + done > 1 && prev_e &&
+                           prev_e->value == cur_inserts) {
                     report(1,
                            "ERROR: Need to allocate separate string for each "
                            "queue element");
                     ok = false;
                     break;
                 }
-                lasts = cur_inserts;
-            } else {
-                fail_count++;
+            }
+
+            if (done < batch) {
+                fail_count += batch - done;
                 if (fail_count < fail_limit)
-                    report(2, "Insertion of %s failed", inserts);
+                    report(2, "Insertion of %s failed", strs[done]);
                 else {
                     report(1,
                            "ERROR: Insertion of %s failed (%d failures total)",
-                           inserts, fail_count);
+                           strs[done], fail_count);
                     ok = false;
                 }
             }
+            r += batch;
             ok = ok && !error_check();
         }
     }
@@ -286,6 +367,63 @@ static bool do_it(int argc, char *argv[])
     return queue_insert(POS_TAIL, argc, argv);
 }
 
+/* Remove up to n elements at once and release them.
+ * If expect is non-NULL, compare it with the element a single removal at
+ * the same end would have returned.
+ */
+static bool queue_remove_n(position_t pos, const char *expect, int n)
+{
+    if (!current || !current->size)
+        report(3, "Warning: Calling remove %s on empty queue",
+               pos == POS_TAIL ? "tail" : "head");
+    error_check();
+
+    LIST_HEAD(removed);
+    int cnt = 0;
+    if (current && exception_setup(true))
+        cnt = pos == POS_TAIL ? q_remove_tail_n(current->q, &removed, n)
+                              : q_remove_head_n(current->q, &removed, n);
+    exception_cancel();
+
+    bool ok = true;
+    int expected = current ? (n < current->size ? n : current->size) : 0;
+    if (cnt != expected) {
+        report(1, "ERROR: Removed %d elements, but %d were expected", cnt,
+               expected);
+        ok = false;
+    }
+
+    if (cnt > 0) {
+        element_t *e = pos == POS_TAIL
+                           ? list_last_entry(&removed, element_t, list)
+                           : list_first_entry(&removed, element_t, list);
+        if (expect && strcmp(e->value, expect)) {
+            report(1, "ERROR: Removed value %s != expected value %s",
+                   e->value, expect);
+            ok = false;
+        } else {
+            report(2, "Removed %d elements from queue", cnt);
+        }
+
+        element_t *tmp;
+        list_for_each_entry_safe (e, tmp, &removed, list)
+            q_release_element(e);
+        current->size -= cnt;
+    } else if (expected) {
+        fail_count++;
+        if (!expect && fail_count < fail_limit) {
+            report(2, "Removal from queue failed");
+        } else {
+            report(1, "ERROR: Removal from queue failed (%d failures total)",
+                   fail_count);
+            ok = false;
+        }
+    }
+
+    q_show(3);
+    return ok && !error_check();
+}
+
 static bool queue_remove(position_t pos, int argc, char *argv[])
 {
     /* FIXME: It is known that both functions is_remove_tail_const() and
@@ -294,12 +432,27 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
      */
 #if !(defined(__aarch64__) && defined(__APPLE__))
     if (simulation) {
-        if (argc != 1) {
-            report(1, "%s does not need arguments in simulation mode", argv[0]);
+        int batch = 1;
+        if (argc == 3 && !strcmp(argv[1], "*")) {
+            if (!get_int(argv[2], &batch) || batch < 1) {
+                report(1, "Invalid number of removals '%s'", argv[2]);
+                return false;
+            }
+            /* A single removal is timed by the single-element test */
+            if (batch > 1)
+                dut_set_batch(batch);
+        } else if (argc != 1) {
+            report(1, "%s takes no arguments or '* n' in simulation mode",
+                   argv[0]);
             return false;
         }
-        bool ok =
-            pos == POS_TAIL ? is_remove_tail_const() : is_remove_head_const();
+        bool ok;
+        if (batch > 1)
+            ok = pos == POS_TAIL ? is_remove_tail_n_const()
+                                 : is_remove_head_n_const();
+        else
+            ok = pos == POS_TAIL ? is_remove_tail_const()
+                                 : is_remove_head_const();
         if (!ok) {
             report(1,
                    "ERROR: Probably not constant time or wrong implementation");
@@ -310,11 +463,20 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
     }
 #endif
 
-    if (argc != 1 && argc != 2) {
-        report(1, "%s needs 0-1 arguments", argv[0]);
+    if (argc < 1 || argc > 3) {
+        report(1, "%s needs 0-2 arguments", argv[0]);
         return false;
     }
 
+    int reps = 1;
+    if (argc == 3 && (!get_int(argv[2], &reps) || reps < 1)) {
+        report(1, "Invalid number of removals '%s'", argv[2]);
+        return false;
+    }
+    if (reps > 1)
+        return queue_remove_n(pos, strcmp(argv[1], "*") ? argv[1] : NULL,
+                              reps);
+
     char *removes = malloc(string_length + STRINGPAD + 1);
     if (!removes) {
         report(1,
@@ -330,7 +492,7 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
         return false;
     }
 
-    bool check = argc > 1;
+    bool check = argc > 1 && strcmp(argv[1], "*");
     bool ok = true;
     if (check) {
         strncpy(checks, argv[1], string_length + 1);
@@ -347,14 +509,32 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
     error_check();
 
     element_t *re = NULL;
-    if (current && exception_setup(true))
-        re = pos == POS_TAIL
-                 ? q_remove_tail(current->q, removes, string_length + 1)
-                 : q_remove_head(current->q, removes, string_length + 1);
+    char *value = NULL;
+    if (current && exception_setup(true)) {
+        if (zerocopy_mode)
+            re = pos == POS_TAIL ? q_remove_tail_nocopy(current->q, &value)
+                                 : q_remove_head_nocopy(current->q, &value);
+        else
+            re = pos == POS_TAIL
+                     ? q_remove_tail(current->q, removes, string_length + 1)
+                     : q_remove_head(current->q, removes, string_length + 1);
+    }
     exception_cancel();
 
     bool is_null = re ? false : true;
 
+    if (!is_null && zerocopy_mode) {
+        /* The handed out pointer must be the one owned by the element */
+        if (!value || value != re->value) {
+            report(1, "ERROR: Removed value pointer %p != element value %p",
+                   (void *) value, (void *) re->value);
+            ok = false;
+        } else {
+            strncpy(removes, value, string_length);
+            removes[string_length] = '\0';
+        }
+    }
+
     if (!is_null) {
         // q_remove_head and q_remove_tail are not responsible for releasing
         // node
@@ -415,10 +595,72 @@ static inline bool do_rt(int argc, char *argv[])
     return queue_remove(POS_TAIL, argc, argv);
 }
 
+/* Decide which of the n strings in l_copy survive an unsorted dedup.
+ * Equal strings are grouped with a table of our own, hashed differently from
+ * the implementation (djb2), so that the check stays independent of it while
+ * still taking linear time on large benchmark queues.
+ */
+static bool *dedup_expect(struct list_head *l_copy, int n, bool keep_first)
+{
+    size_t cap = 16;
+    while (cap < (size_t) n * 2)
+        cap <<= 1;
+    bool *keep = malloc(n * sizeof(bool) + 1);
+    bool *seen_twice = malloc(n * sizeof(bool) + 1);
+    const char **values = malloc(n * sizeof(char *) + 1);
+    int *table = malloc(cap * sizeof(int));
+    if (!keep || !seen_twice || !values || !table) {
+        free(keep);
+        free(seen_twice);
+        free(values);
+        free(table);
+        return NULL;
+    }
+
+    /* table holds the index of the first occurrence plus one, 0 if empty */
+    memset(table, 0, cap * sizeof(int));
+    int i = 0;
+    element_t *item;
+    list_for_each_entry (item, l_copy, list) {
+        unsigned long h = 5381;
+        for (const char *c = item->value; *c; c++)
+            h = h * 33 + (unsigned char) *c;
+        size_t slot = h & (cap - 1);
+        while (table[slot] && strcmp(values[table[slot] - 1], item->value))
+            slot = (slot + 1) & (cap - 1);
+        values[i] = item->value;
+        seen_twice[i] = false;
+        if (table[slot]) {
+            keep[i] = false;
+            seen_twice[table[slot] - 1] = true;
+        } else {
+            keep[i] = true;
+            table[slot] = i + 1;
+        }
+        i++;
+    }
+    if (!keep_first) {
+        for (i = 0; i < n; i++)
+            keep[i] = keep[i] && !seen_twice[i];
+    }
+
+    free(seen_twice);
+    free(values);
+    free(table);
+    return keep;
+}
+
+/* dedup [mode]
+ * mode 0: delete adjacent duplicates of a sorted queue with q_delete_dup()
+ * mode 1: delete every string occurring more than once, queue may be unsorted
+ * mode 2: keep only the first occurrence of every string, may be unsorted
+ */
 static bool do_dedup(int argc, char *argv[])
 {
-    if (argc != 1) {
-        report(1, "%s takes no arguments", argv[0]);
+    int mode = 0;
+    if (argc > 2 ||
+        (argc == 2 && (!get_int(argv[1], &mode) || mode < 0 || mode > 2))) {
+        report(1, "%s takes an optional mode 0, 1 or 2", argv[0]);
         return false;
     }
 
@@ -429,6 +671,8 @@ static bool do_dedup(int argc, char *argv[])
 
     LIST_HEAD(l_copy);
     element_t *item = NULL, *tmp = NULL;
+    int n = 0;
+    q_flatten(current->q);
 
     // Copy current->q to l_copy
     if (current->q && !list_empty(current->q)) {
@@ -446,6 +690,7 @@ static bool do_dedup(int argc, char *argv[])
             }
             memcpy(tmp->value, item->value, slen);
             list_add_tail(&tmp->list, &l_copy);
+            n++;
         }
         // Return false if the loop does not leave properly
         if (&item->list != current->q) {
@@ -460,9 +705,25 @@ static bool do_dedup(int argc, char *argv[])
         }
     }
 
+    bool *keep = NULL;
+    if (mode) {
+        keep = dedup_expect(&l_copy, n, mode == 2);
+        if (!keep) {
+            list_for_each_entry_safe (item, tmp, &l_copy, list) {
+                free(item->value);
+                free(item);
+            }
+            report(1,
+                   "INTERNAL ERROR.  Could not allocate space for "
+                   "duplicate checking");
+            return false;
+        }
+    }
+
     bool ok = true;
     if (exception_setup(true))
-        ok = q_delete_dup(current->q);
+        ok = mode ? q_delete_dup_unsorted(current->q, mode == 2)
+                  : q_delete_dup(current->q);
     exception_cancel();
 
     if (!ok) {
@@ -470,12 +731,28 @@ static bool do_dedup(int argc, char *argv[])
             free(item->value);
             free(item);
         }
-        report(1, "ERROR: Calling delete duplicate on null queue");
+        free(keep);
+        if (!mode) {
+            report(1, "ERROR: Calling delete duplicate on null queue");
+            return false;
+        }
+
+        /* The hash table could not be allocated, and the queue is intact */
+        fail_count++;
+        if (fail_probability > 0 && fail_count < fail_limit) {
+            report(2, "Allocation for delete duplicate failed");
+            return !error_check();
+        }
+        report(1,
+               "ERROR: Allocation for delete duplicate failed (%d failures "
+               "total)",
+               fail_count);
         return false;
     }
 
     struct list_head *l_tmp = current->q->next;
     bool is_this_dup = false;
+    int i = 0;
     // Compare between new list and old one
     list_for_each_entry (item, &l_copy, list) {
         // Skip comparison with new list if the string is duplicate
@@ -483,6 +760,10 @@ static bool do_dedup(int argc, char *argv[])
             item->list.next != &l_copy &&
             strcmp(list_entry(item->list.next, element_t, list)->value,
                    item->value) == 0;
+        if (keep) {
+            is_this_dup = false;
+            is_next_dup = !keep[i++];
+        }
         if (is_this_dup || is_next_dup) {
             // Update list size
             current->size--;
@@ -505,6 +786,7 @@ static bool do_dedup(int argc, char *argv[])
         free(item->value);
         free(item);
     }
+    free(keep);
 
     q_show(3);
     return ok && !error_check();
@@ -563,6 +845,9 @@ static bool do_size(int argc, char *argv[])
     }
     exception_cancel();
 
+    if (current && ok)
+        ok = q_check_size();
+
     if (current && ok) {
         if (current->size == cnt) {
             report(2, "Queue size = %d", cnt);
@@ -629,6 +914,120 @@ bool do_sort(int argc, char *argv[])
     return ok && !error_check();
 }
 
+/* Check that no element ahead of position k is ordered after the element
+ * there and none behind it is ordered before it, and that the first
+ * @nsorted elements are sorted.
+ */
+static bool partitioned_at(struct list_head *head, int k, int nsorted)
+{
+    int sign = descend ? -1 : 1;
+    element_t *pivot = NULL, *prev = NULL, *e;
+    int i = 0;
+    list_for_each_entry (e, head, list) {
+        if (i++ == k) {
+            pivot = e;
+            break;
+        }
+    }
+
+    i = 0;
+    list_for_each_entry (e, head, list) {
+        int c = sign * strcmp(e->value, pivot->value);
+        if ((i < k && c > 0) || (i > k && c < 0)) {
+            report(1, "ERROR: %s at position %d is on the wrong side of %s",
+                   e->value, i, pivot->value);
+            return false;
+        }
+        if (i < nsorted && prev &&
+            sign * strcmp(prev->value, e->value) > 0) {
+            report(1, "ERROR: First %d elements not in %s order", nsorted,
+                   descend ? "descending" : "ascending");
+            return false;
+        }
+        prev = e;
+        i++;
+    }
+    return true;
+}
+
+static bool do_kth(int argc, char *argv[])
+{
+    int k;
+    if (argc != 2 || !get_int(argv[1], &k)) {
+        report(1, "%s needs a position", argv[0]);
+        return false;
+    }
+
+    if (!current || !current->q) {
+        report(3, "Warning: Try to access null queue");
+        return false;
+    }
+    error_check();
+
+    element_t *e = NULL;
+    set_noallocate_mode(true);
+    if (exception_setup(true))
+        e = q_select_kth(current->q, k, descend);
+    exception_cancel();
+    set_noallocate_mode(false);
+
+    bool ok = true;
+    if (k < 0 || k >= current->size) {
+        if (e) {
+            report(1, "ERROR: Found an element at position %d of %d", k,
+                   current->size);
+            ok = false;
+        }
+    } else if (!e) {
+        report(1, "ERROR: No element found at position %d", k);
+        ok = false;
+    } else if (q_peek(current->q, k) != e) {
+        report(1, "ERROR: Element found is not at position %d", k);
+        ok = false;
+    } else {
+        report(2, "Element %d in sorting order: %s", k, e->value);
+        ok = partitioned_at(current->q, k, 0);
+    }
+
+    q_show(3);
+    return ok && !error_check();
+}
+
+static bool do_topk(int argc, char *argv[])
+{
+    int k;
+    if (argc != 2 || !get_int(argv[1], &k)) {
+        report(1, "%s needs a number of elements", argv[0]);
+        return false;
+    }
+
+    if (!current || !current->q) {
+        report(3, "Warning: Try to access null queue");
+        return false;
+    }
+    error_check();
+
+    int cnt = 0;
+    set_noallocate_mode(true);
+    if (exception_setup(true))
+        cnt = q_top_k(current->q, k, descend);
+    exception_cancel();
+    set_noallocate_mode(false);
+
+    int expect = k < 0 ? 0 : k < current->size ? k : current->size;
+    bool ok = true;
+    if (cnt != expect) {
+        report(1, "ERROR: Brought %d elements to the front, expected %d", cnt,
+               expect);
+        ok = false;
+    } else if (cnt) {
+        ok = partitioned_at(current->q, cnt - 1, cnt);
+    }
+
+    q_show(3);
+    return ok && !error_check();
+}
+
 static bool do_dm(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -824,7 +1223,7 @@ static bool do_merge(int argc, char *argv[])
     exception_cancel();
     set_noallocate_mode(false);
 
-    if (q_size(&chain.head) > 1) {
+    if (chain.size > 1) {
         chain.size = 1;
         current = list_entry(chain.head.next, queue_contex_t, chain);
         current->size = len;
@@ -905,11 +1304,15 @@ static bool q_show(int vlevel)
         return true;
     }
 
+    q_flatten(current->q);
     if (!is_circular()) {
         report(vlevel, "ERROR:  Queue is not doubly circular");
         return false;
     }
 
+    if (!q_check_size())
+        return false;
+
     report_noreturn(vlevel, "l = [");
 
     struct list_head *ori = current->q;
@@ -953,6 +1356,653 @@ static bool q_show(int vlevel)
     return ok;
 }
 
+/* Latencies are counted in log-linear buckets: 8 buckets per power of two,
+ * so every percentile is reported within 12.5% of the measured value.
+ */
+#define LAT_BUCKETS 512
+
+static inline int lat_bucket(uint64_t ns)
+{
+    if (ns < 8)
+        return (int) ns;
+    int lg = 63 - __builtin_clzll(ns);
+    return (lg - 2) * 8 + (int) ((ns >> (lg - 3)) & 7);
+}
+
+static inline uint64_t lat_value(int bucket)
+{
+    if (bucket < 8)
+        return bucket;
+    return (uint64_t) (8 + bucket % 8) << (bucket / 8 - 1);
+}
+
+static inline uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* State of one producer or consumer thread of the mpmc command.
+ * Everything a worker writes is allocated up front by the main thread, so
+ * that allocation does not show up in the latencies measured.
+ */
+typedef struct {
+    cq_t *q;
+    int id, producers, ops; /* ops inserted by every producer */
+    atomic_int *consumed;
+    int total;
+    int *last_seq; /* Consumers: last sequence number seen per producer */
+    bool ok;
+    uint64_t max_latency;
+    uint32_t hist[LAT_BUCKETS];
+} mpmc_worker_t;
+
+static void *mpmc_producer(void *arg)
+{
+    mpmc_worker_t *w = arg;
+    cq_handle_t *h = cq_attach(w->q);
+    if (!h) {
+        w->ok = false;
+        return NULL;
+    }
+
+    for (int seq = 0; seq < w->ops; seq++) {
+        /* Encode producer and sequence number, never NULL */
+        void *value = (void *) (uintptr_t) (w->id * w->ops + seq + 1);
+        uint64_t start = now_ns();
+        while (!cq_insert_tail(h, value))
+            sched_yield();
+        uint64_t ns = now_ns() - start;
+        w->hist[lat_bucket(ns)]++;
+        if (ns > w->max_latency)
+            w->max_latency = ns;
+    }
+    cq_detach(h);
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    mpmc_worker_t *w = arg;
+    cq_handle_t *h = cq_attach(w->q);
+    if (!h) {
+        w->ok = false;
+        return NULL;
+    }
+
+    while (atomic_load(w->consumed) < w->total) {
+        uint64_t start = now_ns();
+        void *value = cq_remove_head(h);
+        if (!value)
+            continue;
+        uint64_t ns = now_ns() - start;
+        w->hist[lat_bucket(ns)]++;
+        if (ns > w->max_latency)
+            w->max_latency = ns;
+        atomic_fetch_add(w->consumed, 1);
+
+        /* Values of one producer must come out in the order they went in */
+        int x = (int) ((uintptr_t) value - 1);
+        int producer = x / w->ops, seq = x % w->ops;
+        if (producer >= w->producers || seq <= w->last_seq[producer])
+            w->ok = false;
+        else
+            w->last_seq[producer] = seq;
+    }
+    cq_detach(h);
+    return NULL;
+}
+
+/* Report percentiles of the latencies counted by workers [from, to) */
+static void mpmc_report_latency(const char *name,
+                                mpmc_worker_t *workers,
+                                int from,
+                                int to)
+{
+    static const double pct[] = {50, 99, 99.9};
+    uint64_t count = 0, max = 0;
+    for (int i = from; i < to; i++) {
+        for (int b = 0; b < LAT_BUCKETS; b++)
+            count += workers[i].hist[b];
+        if (workers[i].max_latency > max)
+            max = workers[i].max_latency;
+    }
+
+    uint64_t p[3];
+    for (int k = 0; k < 3; k++) {
+        uint64_t rank = (uint64_t) (count * pct[k] / 100), seen = 0;
+        int b = 0;
+        for (; b < LAT_BUCKETS - 1; b++) {
+            for (int i = from; i < to; i++)
+                seen += workers[i].hist[b];
+            if (seen > rank)
+                break;
+        }
+        p[k] = lat_value(b);
+    }
+    report(1,
+           "%s latency: p50 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns",
+           name, (unsigned long long) p[0], (unsigned long long) p[1],
+           (unsigned long long) p[2], (unsigned long long) max);
+}
+
+/* Run producers and consumers concurrently on a lock-free queue */
+static bool do_mpmc(int argc, char *argv[])
+{
+    int producers = 4, consumers = 4, ops = 100000;
+    if (argc > 4 || (argc > 1 && !get_int(argv[1], &producers)) ||
+        (argc > 2 && !get_int(argv[2], &consumers)) ||
+        (argc > 3 && !get_int(argv[3], &ops))) {
+        report(1, "%s takes up to three numbers", argv[0]);
+        return false;
+    }
+    if (producers < 1 || consumers < 1 || producers + consumers > 64 ||
+        ops < 1 || (long) producers * ops >= INT32_MAX) {
+        report(1,
+               "Need 1-64 threads in total, at least one of each kind, and "
+               "fewer than 2^31 values");
+        return false;
+    }
+
+    int n = producers + consumers, total = producers * ops;
+    mpmc_worker_t *workers = calloc(n, sizeof(mpmc_worker_t));
+    int *last_seq = malloc(consumers * producers * sizeof(int));
+    pthread_t *tid = malloc(n * sizeof(pthread_t));
+    cq_t *q = cq_new();
+    if (!workers || !last_seq || !tid || !q) {
+        report(1, "INTERNAL ERROR.  Could not allocate space for mpmc run");
+        free(workers);
+        free(last_seq);
+        free(tid);
+        cq_free(q);
+        return false;
+    }
+
+    atomic_int consumed;
+    atomic_init(&consumed, 0);
+    for (int i = 0; i < n; i++) {
+        workers[i] = (mpmc_worker_t){.q = q,
+                                     .id = i < producers ? i : i - producers,
+                                     .producers = producers,
+                                     .ops = ops,
+                                     .consumed = &consumed,
+                                     .total = total,
+                                     .ok = true};
+        if (i >= producers)
+            workers[i].last_seq = last_seq + (i - producers) * producers;
+    }
+    for (int i = 0; i < consumers * producers; i++)
+        last_seq[i] = -1;
+
+    /* Keep the time limit of qtest away from the workers, as q_sort does */
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    uint64_t start = now_ns();
+    int started = 0;
+    for (; started < n; started++) {
+        void *(*fn)(void *) =
+            started < producers ? mpmc_producer : mpmc_consumer;
+        if (pthread_create(&tid[started], NULL, fn, &workers[started]))
+            break;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    bool ok = true;
+    if (started < n) {
+        /* Without every producer, consumers would wait forever */
+        report(1, "ERROR: Could only start %d of %d threads", started, n);
+        atomic_store(&consumed, total);
+        ok = false;
+    }
+    for (int i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+    double elapsed = (now_ns() - start) / 1e9;
+
+    for (int i = 0; i < n && ok; i++) {
+        if (!workers[i].ok) {
+            report(1, "ERROR: Values lost, duplicated or out of order");
+            ok = false;
+        }
+    }
+    cq_handle_t *h = cq_attach(q);
+    if (ok && h && cq_remove_head(h)) {
+        report(1, "ERROR: Queue not empty after all values were removed");
+        ok = false;
+    }
+    cq_detach(h);
+
+    if (ok) {
+        report(1, "%d producers, %d consumers: %d values in %.3f s, %.0f ops/s",
+               producers, consumers, total, elapsed, 2 * total / elapsed);
+        mpmc_report_latency("Insert", workers, 0, producers);
+        mpmc_report_latency("Remove", workers, producers, n);
+    }
+
+    cq_free(q);
+    free(workers);
+    free(last_seq);
+    free(tid);
+    return ok;
+}
+
+/* State of one producer or consumer thread of the lqbench command.
+ * Producers first build their own queue of elements, concurrently with each
+ * other, then move them to the tail of the shared deque once every producer
+ * is ready.  Consumers move elements from its head to their own sink.
+ */
+typedef struct {
+    lq_t *q;
+    int id, ops;              /* Producers: insert "id-seq" for seq < ops */
+    struct list_head *source; /* Producers: elements to insert */
+    struct list_head sink;    /* Consumers: elements removed */
+    atomic_int *ready, *consumed;
+    atomic_bool *go;
+    int total;
+    bool short_source; /* Producers: allocation failed while building */
+} lq_worker_t;
+
+static void *lq_producer(void *arg)
+{
+    lq_worker_t *w = arg;
+    char buf[32];
+    int seq;
+    for (seq = 0; seq < w->ops; seq++) {
+        snprintf(buf, sizeof(buf), "%d-%d", w->id, seq);
+        if (!q_insert_tail(w->source, buf))
+            break;
+    }
+    /* Count the values never built as consumed, so consumers still stop */
+    if (seq < w->ops) {
+        w->short_source = true;
+        atomic_fetch_add(w->consumed, w->ops - seq);
+    }
+    atomic_fetch_add(w->ready, 1);
+    while (!atomic_load(w->go))
+        sched_yield();
+
+    element_t *e;
+    while ((e = q_remove_head(w->source, NULL, 0)))
+        lq_insert_tail(w->q, e);
+    return NULL;
+}
+
+static void *lq_consumer(void *arg)
+{
+    lq_worker_t *w = arg;
+    while (!atomic_load(w->go))
+        sched_yield();
+    while (atomic_load(w->consumed) < w->total) {
+        element_t *e = lq_remove_head(w->q);
+        if (!e) {
+            sched_yield();
+            continue;
+        }
+        atomic_fetch_add(w->consumed, 1);
+        list_add_tail(&e->list, &w->sink);
+    }
+    return NULL;
+}
+
+/* Pass n elements per producer through a deque locked as requested.
+ * Return the run time in seconds, or a negative value on error.
+ */
+static double lq_run(bool global_lock, int producers, int consumers, int ops)
+{
+    int n = producers + consumers, total = producers * ops;
+    lq_worker_t *workers = calloc(n, sizeof(lq_worker_t));
+    pthread_t *tid = malloc(n * sizeof(pthread_t));
+    lq_t *q = lq_new(global_lock);
+    double elapsed = -1;
+    int started = 0, ready = 0;
+    atomic_int consumed, filled;
+    atomic_bool go;
+    atomic_init(&consumed, 0);
+    atomic_init(&filled, 0);
+    atomic_init(&go, false);
+    if (!workers || !tid || !q)
+        goto out;
+
+    for (; ready < producers; ready++) {
+        lq_worker_t *w = &workers[ready];
+        w->source = q_new();
+        if (!w->source)
+            goto out;
+        w->q = q;
+        w->id = ready;
+        w->ops = ops;
+        w->ready = &filled;
+        w->consumed = &consumed;
+        w->go = &go;
+    }
+    for (int i = producers; i < n; i++) {
+        workers[i].q = q;
+        INIT_LIST_HEAD(&workers[i].sink);
+        workers[i].consumed = &consumed;
+        workers[i].go = &go;
+        workers[i].total = total;
+    }
+
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    for (; started < n; started++) {
+        void *(*fn)(void *) = started < producers ? lq_producer : lq_consumer;
+        if (pthread_create(&tid[started], NULL, fn, &workers[started]))
+            break;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (started < n) {
+        report(1, "ERROR: Could only start %d of %d threads", started, n);
+        atomic_store(&consumed, total);
+    }
+    /* Only time the transfer, not the producers building their elements */
+    while (started == n && atomic_load(&filled) < producers)
+        sched_yield();
+    uint64_t start = now_ns();
+    atomic_store(&go, true);
+    for (int i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+    if (started == n)
+        elapsed = (now_ns() - start) / 1e9;
+
+    /* Every value must come out once, in the order of its producer */
+    int *next_seq = calloc(producers, sizeof(int));
+    if (!next_seq)
+        elapsed = -1;
+    for (int i = producers; i < n && elapsed >= 0; i++) {
+        memset(next_seq, 0, producers * sizeof(int));
+        element_t *e;
+        list_for_each_entry (e, &workers[i].sink, list) {
+            int p, seq;
+            if (sscanf(e->value, "%d-%d", &p, &seq) != 2 || p < 0 ||
+                p >= producers || seq < next_seq[p]) {
+                report(1, "ERROR: Value %s out of order", e->value);
+                elapsed = -1;
+                break;
+            }
+            next_seq[p] = seq + 1;
+        }
+    }
+    free(next_seq);
+    for (int i = 0; i < producers && elapsed >= 0; i++) {
+        if (workers[i].short_source) {
+            report(1, "ERROR: Producer %d could not allocate its values", i);
+            elapsed = -1;
+        }
+    }
+    if (elapsed >= 0 && (atomic_load(&consumed) != total || lq_size(q))) {
+        report(1, "ERROR: %d of %d values consumed, %d left in deque",
+               atomic_load(&consumed), total, lq_size(q));
+        elapsed = -1;
+    }
+
+out:
+    if (elapsed < 0 && !started)
+        report(1, "INTERNAL ERROR.  Could not set up lqbench run");
+    for (int i = 0; workers && i < n; i++) {
+        if (i < ready) {
+            q_free(workers[i].source);
+        } else if (i >= producers) {
+            element_t *e, *tmp;
+            list_for_each_entry_safe (e, tmp, &workers[i].sink, list)
+                q_release_element(e);
+        }
+    }
+    lq_free(q);
+    free(workers);
+    free(tid);
+    return elapsed;
+}
+
+/* Compare a two-lock deque with a deque under a single global mutex */
+static bool do_lqbench(int argc, char *argv[])
+{
+    int producers = 4, consumers = 4, ops = 100000;
+    if (argc > 4 || (argc > 1 && !get_int(argv[1], &producers)) ||
+        (argc > 2 && !get_int(argv[2], &consumers)) ||
+        (argc > 3 && !get_int(argv[3], &ops))) {
+        report(1, "%s takes up to three numbers", argv[0]);
+        return false;
+    }
+    if (producers < 1 || consumers < 1 || producers + consumers > 64 ||
+        ops < 1 || (long) producers * ops >= INT32_MAX) {
+        report(1,
+               "Need 1-64 threads in total, at least one of each kind, and "
+               "fewer than 2^31 values");
+        return false;
+    }
+
+    for (int global = 1; global >= 0; global--) {
+        double elapsed = lq_run(global, producers, consumers, ops);
+        if (elapsed < 0)
+            return false;
+        report(1, "%s: %d producers, %d consumers: %.3f s, %.0f ops/s",
+               global ? "Global mutex" : "Two locks", producers, consumers,
+               elapsed, 2.0 * producers * ops / elapsed);
+    }
+    return true;
+}
+
+static bool do_alloc_stats(int argc, char *argv[])
+{
+    if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+        report(1, "%s takes no arguments or 'reset'", argv[0]);
+        return false;
+    }
+
+    if (argc == 2)
+        set_alloc_profile(profile_mode != 0);
+    else
+        alloc_profile_report();
+    return true;
+}
+
+/* Check that the first n bytes of a block still hold the pattern of
+ * do_realloc()
+ */
+static bool realloc_kept(const unsigned char *p, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] != (unsigned char) i)
+            return false;
+    }
+    return true;
+}
+
+/* Take a block of n bytes through every path of test_realloc(): allocate it
+ * from NULL, grow it, shrink it, and free it with size 0.  A block shrinks in
+ * place unless it is guarded, in which case it has to move.  With 'corrupt',
+ * overwrite the footer of the block instead and expect realloc to notice.
+ */
+static bool do_realloc(int argc, char *argv[])
+{
+    bool corrupt = argc == 2 && !strcmp(argv[1], "corrupt");
+    int n = 64;
+    if (argc > 2 ||
+        (argc == 2 && !corrupt && (!get_int(argv[1], &n) || n < 2))) {
+        report(1, "%s takes a size of at least 2 or 'corrupt'", argv[0]);
+        return false;
+    }
+
+    size_t bcnt = allocation_check();
+    error_check();
+
+    unsigned char *p = test_realloc(NULL, n);
+    if (!p) {
+        report(3, "Warning: realloc(NULL, %d) returned NULL", n);
+        return true;
+    }
+    for (int i = 0; i < n; i++)
+        p[i] = (unsigned char) i;
+
+    bool ok = true;
+    if (corrupt) {
+        p[n] ^= 0xff;
+        unsigned char *q = test_realloc(p, 2 * n);
+        if (!error_check()) {
+            report(1, "ERROR: Corrupted footer not detected by realloc");
+            ok = false;
+        }
+        test_free(q ? q : p);
+        error_check();
+        return ok && allocation_check() == bcnt;
+    }
+
+    unsigned char *q = test_realloc(p, 2 * n);
+    if (!q) {
+        report(3, "Warning: realloc to %d bytes returned NULL", 2 * n);
+        q = p;
+    } else if (!realloc_kept(q, n)) {
+        report(1, "ERROR: Growing to %d bytes lost the contents", 2 * n);
+        ok = false;
+    }
+
+    unsigned char *r = test_realloc(q, n / 2);
+    if (!r) {
+        report(1, "ERROR: Shrinking to %d bytes returned NULL", n / 2);
+        test_free(q);
+        return false;
+    }
+    if (!realloc_kept(r, n / 2)) {
+        report(1, "ERROR: Shrinking to %d bytes lost the contents", n / 2);
+        ok = false;
+    }
+    if (!guard_mode && r != q) {
+        report(1, "ERROR: Shrinking to %d bytes moved the block", n / 2);
+        ok = false;
+    } else if (guard_mode == 1 && r == q) {
+        report(1, "ERROR: Shrinking a guarded block kept it in place");
+        ok = false;
+    }
+
+    if (test_realloc(r, 0)) {
+        report(1, "ERROR: realloc to 0 bytes did not return NULL");
+        ok = false;
+    }
+    if (allocation_check() != bcnt) {
+        report(1, "ERROR: realloc left %zu blocks allocated",
+               allocation_check() - bcnt);
+        ok = false;
+    }
+    return ok && !error_check();
+}
+
+/* Input distributions of the sort benchmark */
+typedef enum {
+    DIST_RANDOM,
+    DIST_SORTED,
+    DIST_REVERSE,
+    DIST_DUPLICATES,
+    DIST_SAWTOOTH,
+    DIST_ORGAN_PIPE,
+    DIST_COUNT,
+} dist_t;
+
+static const char *const dist_names[] = {
+    "random", "sorted", "reverse", "dups", "sawtooth", "organpipe",
+};
+
+/* Number whose string the i-th of n elements gets under a distribution */
+static unsigned long dist_key(dist_t dist, int i, int n)
+{
+    switch (dist) {
+    case DIST_RANDOM:
+        return ((unsigned long) rand() << 16) ^ (unsigned long) rand();
+    case DIST_SORTED:
+        return i;
+    case DIST_REVERSE:
+        return n - i;
+    case DIST_DUPLICATES:
+        return rand() % 16;
+    case DIST_SAWTOOTH:
+        return i % (n / 16 + 1);
+    default:
+        return i < n / 2 ? i : n - i;
+    }
+}
+
+/* Sort n elements of one distribution, report the cost and whether the
+ * result was sorted.
+ */
+static bool bench_sort_run(dist_t dist, int n)
+{
+    struct list_head *q = q_new();
+    if (!q) {
+        report(1, "INTERNAL ERROR.  Could not allocate queue");
+        return false;
+    }
+
+    /* Seven lowercase letters in base 26 order strings as their numbers */
+    char buf[8];
+    for (int i = 0; i < n; i++) {
+        unsigned long key = dist_key(dist, i, n);
+        for (int d = 6; d >= 0; d--, key /= 26)
+            buf[d] = charset[key % 26];
+        buf[7] = '\0';
+        if (!q_insert_tail(q, buf)) {
+            report(1, "ERROR: Could not insert %d elements", n);
+            q_free(q);
+            return false;
+        }
+    }
+
+    q_count_compares(true);
+    set_noallocate_mode(true);
+    uint64_t start = now_ns();
+    if (exception_setup(false))
+        q_sort(q, descend);
+    exception_cancel();
+    uint64_t elapsed = now_ns() - start;
+    set_noallocate_mode(false);
+    unsigned long compares = q_compares();
+    q_count_compares(false);
+
+    bool ok = !error_check();
+    int sign = descend ? -1 : 1;
+    element_t *e, *prev = NULL;
+    list_for_each_entry (e, q, list) {
+        if (ok && prev && sign * strcmp(prev->value, e->value) > 0) {
+            report(1, "ERROR: %s input of %d elements not sorted",
+                   dist_names[dist], n);
+            ok = false;
+        }
+        prev = e;
+    }
+    if (ok)
+        report(1, "%-10s %8d %12lu %10.3f %10.1f", dist_names[dist], n,
+               compares, elapsed / 1e9, (double) elapsed / n);
+    q_free(q);
+    return ok;
+}
+
+/* Run a benchmark over several input distributions and sizes */
+static bool do_bench(int argc, char *argv[])
+{
+    int max = 4 << 20;
+    if (argc < 2 || argc > 3 || strcmp(argv[1], "sort") ||
+        (argc == 3 && !get_int(argv[2], &max))) {
+        report(1, "%s takes 'sort' and an optional maximum size", argv[0]);
+        return false;
+    }
+    if (max < 1024 || max > (16 << 20)) {
+        report(1, "Maximum size must be between 1024 and 16777216");
+        return false;
+    }
+
+    report(1, "%-10s %8s %12s %10s %10s", "Input", "Size", "Compares",
+           "Seconds", "ns/elem");
+    bool ok = true;
+    for (dist_t dist = 0; dist < DIST_COUNT && ok; dist++) {
+        for (int n = 1024; n <= max && ok; n *= 4)
+            ok = bench_sort_run(dist, n);
+    }
+    return ok;
+}
+
 static bool do_show(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -1012,6 +2062,36 @@ static bool do_next(int argc, char *argv[])
     return q_show(0);
 }
 
+static void set_pool_mode(int oldval)
+{
+    q_use_pool(pool_mode != 0);
+}
+
+static void set_prefix_mode(int oldval)
+{
+    q_use_prefix_key(prefix_mode != 0);
+}
+
+static void set_ring_mode(int oldval)
+{
+    q_use_ring(ring_mode != 0);
+}
+
+static void set_profile_mode(int oldval)
+{
+    set_alloc_profile(profile_mode != 0);
+}
+
+static void set_sort_algo(int oldval)
+{
+    q_use_radix_sort(sort_algo == 1);
+}
+
+static void set_sort_threads(int oldval)
+{
+    q_set_sort_threads(sort_threads);
+}
+
 static void console_init()
 {
     ADD_COMMAND(new, "Create new queue", "");
@@ -1026,20 +2106,32 @@ static void console_init()
                 "Insert string str at tail of queue n times. Generate random "
                 "string(s) if str equals RAND. (default: n == 1)",
                 "str [n]");
-    ADD_COMMAND(
-        rh,
-        "Remove from head of queue. Optionally compare to expected value str",
-        "[str]");
-    ADD_COMMAND(
-        rt,
-        "Remove from tail of queue. Optionally compare to expected value str",
-        "[str]");
+    ADD_COMMAND(rh,
+                "Remove n elements from head of queue (default: n == 1). "
+                "Optionally compare the first one to expected value str, "
+                "unless str is '*'",
+                "[str [n]]");
+    ADD_COMMAND(rt,
+                "Remove n elements from tail of queue (default: n == 1). "
+                "Optionally compare the last one to expected value str, "
+                "unless str is '*'",
+                "[str [n]]");
     ADD_COMMAND(reverse, "Reverse queue", "");
     ADD_COMMAND(sort, "Sort queue in ascending/descening order", "");
+    ADD_COMMAND(kth,
+                "Move the element at position k in sorting order there, "
+                "partitioning the queue around it",
+                "k");
+    ADD_COMMAND(topk, "Sort the first k elements in sorting order to the front",
+                "k");
     ADD_COMMAND(size, "Compute queue size n times (default: n == 1)", "[n]");
     ADD_COMMAND(show, "Show queue contents", "");
     ADD_COMMAND(dm, "Delete middle node in queue", "");
-    ADD_COMMAND(dedup, "Delete all nodes that have duplicate string", "");
+    ADD_COMMAND(dedup,
+                "Delete all nodes that have duplicate string. Mode 0 needs a "
+                "sorted queue, 1 also works unsorted, 2 keeps first "
+                "occurrences",
+                "[mode]");
     ADD_COMMAND(merge, "Merge all the queues into one sorted queue", "");
     ADD_COMMAND(swap, "Swap every two adjacent nodes in queue", "");
     ADD_COMMAND(ascend,
@@ -1052,14 +2144,61 @@ static void console_init()
                 "");
     ADD_COMMAND(reverseK, "Reverse the nodes of the queue 'K' at a time",
                 "[K]");
+    ADD_COMMAND(mpmc,
+                "Feed a lock-free queue from p producer threads to c consumer "
+                "threads, n values per producer, and report throughput and "
+                "latency",
+                "[p [c [n]]]");
+    ADD_COMMAND(lqbench,
+                "Move n elements per producer from p producer threads to c "
+                "consumer threads through a locked deque, with a global mutex "
+                "and with per-end locks",
+                "[p [c [n]]]");
+    ADD_COMMAND(bench,
+                "Time sorting random, sorted, reverse, duplicate-heavy, "
+                "sawtooth and organ-pipe input from 1024 elements up to max "
+                "(default 4194304), with the current sort options",
+                "sort [max]");
+    ADD_COMMAND(alloc_stats,
+                "Show the allocation profile by size class and by command, "
+                "or clear it",
+                "[reset]");
+    ADD_COMMAND(realloc,
+                "Grow, shrink and free a block of n bytes (default 64) "
+                "through realloc, or check that realloc detects a corrupted "
+                "footer",
+                "[n | corrupt]");
     add_param("length", &string_length, "Maximum length of displayed string",
               NULL);
     add_param("malloc", &fail_probability, "Malloc failure probability percent",
               NULL);
+    add_param("poison", &poison_mode,
+              "Fill payloads of all blocks (0), none (1) or one in N (N)",
+              NULL);
+    add_param("guard", &guard_mode,
+              "Place one block in N against a guard page (0: none)", NULL);
     add_param("fail", &fail_limit,
               "Number of times allow queue operations to return false", NULL);
     add_param("descend", &descend,
               "Sort and merge queue in ascending/descending order", NULL);
+    add_param("debug", &debug_mode,
+              "Cross-check cached queue size against a full walk", NULL);
+    add_param("pool", &pool_mode,
+              "Allocate elements of new queues from a per-queue pool",
+              set_pool_mode);
+    add_param("prefix", &prefix_mode,
+              "Compare 8-byte prefix keys before calling strcmp",
+              set_prefix_mode);
+    add_param("threads", &sort_threads, "Number of threads used by sort",
+              set_sort_threads);
+    add_param("sortalgo", &sort_algo, "Sort by merging (0) or by radix (1)",
+              set_sort_algo);
+    add_param("zerocopy", &zerocopy_mode,
+              "Remove elements without copying their values", NULL);
+    add_param("ring", &ring_mode, "Create new queues as ring deques",
+              set_ring_mode);
+    add_param("profile", &profile_mode,
+              "Record allocations by size class and command", set_profile_mode);
 }
 
 /* Signal handlers */
@@ -1092,8 +2231,6 @@ static void q_init()
 static bool q_quit(int argc, char *argv[])
 {
     report(3, "Freeing queue");
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
 
     if (exception_setup(true)) {
         struct list_head *cur = chain.head.next;
@@ -1107,7 +2244,6 @@ static bool q_quit(int argc, char *argv[])
     }
 
     exception_cancel();
-    set_cautious_mode(true);
 
     size_t bcnt = allocation_check();
     if (bcnt > 0) {
@@ -1253,6 +2389,7 @@ int main(int argc, char *argv[])
         set_logfile(logfile_name);
 
     add_quit_helper(q_quit);
+    set_cmd_hook(alloc_profile_command);
 
     bool ok = true;
     ok = ok && run_console(infile_name);
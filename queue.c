@@ -1,3 +1,8 @@
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,24 +15,308 @@
  *   cppcheck-suppress nullPointer
  */
 
+/* Pool chunks double in size from the first to the last slot count, so
+ * short queues stay small while long ones rarely hit malloc.
+ */
+#define POOL_FIRST_SLOTS 16
+#define POOL_CHUNK_SLOTS 1024
+
+/* Strings up to this length (including the terminator) are stored inline */
+#define POOL_INLINE_LEN 32
+
+/* A pool slot keeps the element and a short string in the same block */
+typedef struct {
+    element_t elem;
+    char inline_value[POOL_INLINE_LEN];
+} pool_slot_t;
+
+typedef struct __pool_chunk {
+    struct __pool_chunk *next;
+    int used; /* Slots handed out at least once, carved in order */
+    int capacity;
+    pool_slot_t slots[];
+} pool_chunk_t;
+
+/* Per-queue element pool.
+ * Fresh slots are carved in order from the newest chunk, while released
+ * slots are chained through their list member for reuse.  A pool outlives its
+ * queue as long as removed elements still refer to it, so it is destroyed
+ * by whichever comes last: q_free() or the release of its last element.
+ *
+ * Bulk insertion uses the same structure for a one-shot pool: the header,
+ * its slots and the long strings of the batch share a single block, with
+ * @strings delimiting the string area.  Such a pool is orphan from the start.
+ */
+struct q_pool {
+    pool_chunk_t *chunks;
+    struct list_head free_slots;
+    size_t live;
+    bool orphan;
+    char *strings, *strings_end;
+};
+
+/* Queue header handed out by q_new().
+ * The list head must stay in first position: callers only ever see the
+ * struct list_head, and the element count is recovered with container_of.
+ * Every operation that links or unlinks elements keeps @size up to date so
+ * that q_size() does not have to walk the list.
+ *
+ * A queue created with the ring backend keeps its elements in the circular
+ * array @ring instead, starting at @ring_first, while @head stays empty.
+ * Operations other than insertion and removal at both ends call q_flatten()
+ * to link the elements through @head.  The array is kept for the lifetime of
+ * the queue, since flattening may happen with malloc and free disallowed, and
+ * is used again once the list drains.
+ */
+typedef struct __queue {
+    struct list_head head;
+    int size;
+    struct q_pool *pool;
+    element_t **ring;
+    int ring_first, ring_capacity; /* Capacity is a power of two */
+    bool in_ring;
+    /* Pairing heap links and tie-breaking rank, only used by q_merge() */
+    struct __queue *child, *sibling;
+    int rank;
+} queue_t;
+
+#define q_header(h) container_of(h, queue_t, head)
+
+/* Whether queues created by q_new() get an element pool.
+ * The unrolled layout selected at build time turns pools on by default, so
+ * that fresh slots are carved in insertion order out of shared chunks.
+ */
+#ifdef QUEUE_UNROLLED
+static bool pool_enabled = true;
+#else
+static bool pool_enabled = false;
+#endif
+
+void q_use_pool(bool enable)
+{
+    pool_enabled = enable;
+}
+
+static void pool_destroy(struct q_pool *pool)
+{
+    pool_chunk_t *chunk = pool->chunks;
+    while (chunk) {
+        pool_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(pool);
+}
+
+/* Add a chunk of n slots in front of the chunks of the pool */
+static bool pool_grow(struct q_pool *pool, int n)
+{
+    pool_chunk_t *chunk =
+        malloc(sizeof(pool_chunk_t) + n * sizeof(pool_slot_t));
+    if (!chunk)
+        return false;
+    chunk->next = pool->chunks;
+    chunk->used = 0;
+    chunk->capacity = n;
+    pool->chunks = chunk;
+    return true;
+}
+
+/* Take a slot from the pool, growing it by one chunk when exhausted */
+static pool_slot_t *pool_get(struct q_pool *pool)
+{
+    pool_slot_t *slot;
+
+    if (!list_empty(&pool->free_slots)) {
+        slot = list_first_entry(&pool->free_slots, pool_slot_t, elem.list);
+        list_del(&slot->elem.list);
+    } else {
+        pool_chunk_t *chunk = pool->chunks;
+        if (!chunk || chunk->used == chunk->capacity) {
+            int n = chunk ? chunk->capacity * 2 : POOL_FIRST_SLOTS;
+            if (!pool_grow(pool, n < POOL_CHUNK_SLOTS ? n : POOL_CHUNK_SLOTS))
+                return NULL;
+            chunk = pool->chunks;
+        }
+        slot = &chunk->slots[chunk->used++];
+    }
+
+    pool->live++;
+    return slot;
+}
+
+/* Initial capacity of the array of a ring queue */
+#define RING_MIN_CAPACITY 16
+
+/* Whether queues created by q_new() start out as ring deques */
+static bool ring_enabled = false;
+
+void q_use_ring(bool enable)
+{
+    ring_enabled = enable;
+}
+
+static inline element_t **ring_at(const queue_t *q, int i)
+{
+    return &q->ring[(q->ring_first + i) & (q->ring_capacity - 1)];
+}
+
+/* Double the array of a ring queue, in place when realloc can extend it */
+static bool ring_grow(queue_t *q)
+{
+    int capacity = q->ring_capacity;
+    element_t **ring = realloc(q->ring, 2 * capacity * sizeof(element_t *));
+    if (!ring)
+        return false;
+
+    /* Unwrap the elements past the end of the old array */
+    int wrapped = q->ring_first + q->size - capacity;
+    if (wrapped > 0)
+        memcpy(ring + capacity, ring, wrapped * sizeof(element_t *));
+    q->ring = ring;
+    q->ring_capacity = 2 * capacity;
+    return true;
+}
+
+/* Link the elements of a ring queue through its list head, in order */
+void q_flatten(struct list_head *head)
+{
+    if (!head)
+        return;
+
+    queue_t *q = q_header(head);
+    if (!q->in_ring)
+        return;
+    for (int i = 0; i < q->size; i++)
+        list_add_tail(&(*ring_at(q, i))->list, head);
+    q->in_ring = false;
+}
+
+/* Pack the first eight bytes of s, zero padded, into an integer whose
+ * unsigned order agrees with the order strcmp() gives.
+ */
+static inline uint64_t prefix_key(const char *s)
+{
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) {
+        key <<= 8;
+        if (*s)
+            key |= (unsigned char) *s++;
+    }
+    return key;
+}
+
+/* Allocate an element holding a copy of s, either from the pool of the
+ * queue or with one malloc for the node and one for the string.
+ */
+static element_t *q_new_element(struct list_head *head, const char *s)
+{
+    struct q_pool *pool = q_header(head)->pool;
+
+    if (!pool) {
+        element_t *e = malloc(sizeof(element_t));
+        if (!e)
+            return NULL;
+        e->pool = NULL;
+        e->value = strdup(s);
+        if (!e->value) {
+            free(e);
+            return NULL;
+        }
+        e->key = prefix_key(s);
+        return e;
+    }
+
+    pool_slot_t *slot = pool_get(pool);
+    if (!slot)
+        return NULL;
+
+    element_t *e = &slot->elem;
+    e->pool = pool;
+    e->value = slot->inline_value;
+    size_t len = strlen(s) + 1;
+    if (len > POOL_INLINE_LEN) {
+        char *value = strdup(s);
+        if (!value) {
+            q_release_element(e);
+            return NULL;
+        }
+        e->value = value;
+    } else {
+        memcpy(e->value, s, len);
+    }
+    e->key = prefix_key(s);
+    return e;
+}
+
+/* Release an element, handing pooled slots back to their pool */
+void q_release_element(element_t *e)
+{
+    struct q_pool *pool = e->pool;
+    if (!pool) {
+        free(e->value);
+        free(e);
+        return;
+    }
+
+    pool_slot_t *slot = container_of(e, pool_slot_t, elem);
+    if (e->value != slot->inline_value &&
+        (e->value < pool->strings || e->value >= pool->strings_end))
+        free(e->value);
+    list_add(&e->list, &pool->free_slots);
+    if (--pool->live == 0 && pool->orphan)
+        pool_destroy(pool);
+}
 
 /* Create an empty queue */
 struct list_head *q_new()
 {
-    /* Allocate memory dynamically for new list_head */
-    struct list_head *new_head = malloc(sizeof(struct list_head));
+    /* Allocate memory dynamically for new queue header */
+    queue_t *q = malloc(sizeof(queue_t));
 
     /* Check if memory allocation was successful */
-    if (!new_head) {
-        /* Allocation failed, return NULL */
-        free(new_head);
+    if (!q)
         return NULL;
+
+    q->pool = NULL;
+    if (pool_enabled) {
+        q->pool = malloc(sizeof(struct q_pool));
+        if (!q->pool) {
+            free(q);
+            return NULL;
+        }
+        q->pool->chunks = NULL;
+        INIT_LIST_HEAD(&q->pool->free_slots);
+        q->pool->live = 0;
+        q->pool->orphan = false;
+        q->pool->strings = q->pool->strings_end = NULL;
+        /* The first insertions into a new queue should not call malloc */
+        if (!pool_grow(q->pool, POOL_FIRST_SLOTS)) {
+            free(q->pool);
+            free(q);
+            return NULL;
+        }
     }
 
-    /* Initialize the new list_head to point to itself, indicating empty queue
-     */
-    INIT_LIST_HEAD(new_head);
-    return new_head;
+    q->ring = NULL;
+    q->in_ring = false;
+    if (ring_enabled) {
+        q->ring = malloc(RING_MIN_CAPACITY * sizeof(element_t *));
+        if (!q->ring) {
+            if (q->pool)
+                pool_destroy(q->pool);
+            free(q);
+            return NULL;
+        }
+        q->ring_first = 0;
+        q->ring_capacity = RING_MIN_CAPACITY;
+        q->in_ring = true;
+    }
+
+    /* Initialize the list_head to point to itself, indicating empty queue */
+    INIT_LIST_HEAD(&q->head);
+    q->size = 0;
+    return &q->head;
 }
 
 /* Free all storage used by queue */
@@ -39,10 +328,72 @@ void q_free(struct list_head *head)
     element_t *current, *next;  // Pointers for traversing the list
 
     // Traverse the list safely
+    q_flatten(head);
     list_for_each_entry_safe (current, next, head, list) {
         q_release_element(current);
     }
-    free(head);
+    free(q_header(head)->ring);
+
+    // Elements removed earlier may still live in the pool
+    struct q_pool *pool = q_header(head)->pool;
+    if (pool) {
+        pool->orphan = true;
+        if (!pool->live)
+            pool_destroy(pool);
+    }
+    free(q_header(head));
+}
+
+/* Link e at one end of the queue.
+ * A drained queue that owns a ring array goes back to the ring form.
+ */
+static bool q_push(struct list_head *head, element_t *e, bool at_head)
+{
+    queue_t *q = q_header(head);
+    if (q->ring && !q->size) {
+        q->in_ring = true;
+        q->ring_first = 0;
+    }
+
+    if (!q->in_ring) {
+        if (at_head)
+            list_add(&e->list, head);
+        else
+            list_add_tail(&e->list, head);
+    } else {
+        if (q->size == q->ring_capacity && !ring_grow(q))
+            return false;
+        if (at_head) {
+            q->ring_first = (q->ring_first - 1) & (q->ring_capacity - 1);
+            *ring_at(q, 0) = e;
+        } else {
+            *ring_at(q, q->size) = e;
+        }
+    }
+    q->size++;
+    return true;
+}
+
+/* Unlink the element at one end of the queue, NULL if it is empty */
+static element_t *q_pop(struct list_head *head, bool at_head)
+{
+    queue_t *q = q_header(head);
+    if (!q->size)
+        return NULL;
+
+    element_t *e;
+    if (!q->in_ring) {
+        e = at_head ? list_first_entry(head, element_t, list)
+                    : list_last_entry(head, element_t, list);
+        list_del(&e->list);
+    } else if (at_head) {
+        e = *ring_at(q, 0);
+        q->ring_first = (q->ring_first + 1) & (q->ring_capacity - 1);
+    } else {
+        e = *ring_at(q, q->size - 1);
+    }
+    q->size--;
+    return e;
 }
 
 /* Insert an element at head of queue */
@@ -51,26 +402,17 @@ bool q_insert_head(struct list_head *head, char *s)
     if (!head || !s)
         return false;
 
-    // Create a new element
-    element_t *new_element = malloc(sizeof(element_t));
-
-    if (!new_element) {
+    // Create a new element holding a copy of s
+    element_t *new_element = q_new_element(head, s);
+    if (!new_element)
         return false;
-    }
 
-    // Copy s to new element's value
-    new_element->value = strdup(s);
-
-    // Check
-    if (!new_element->value) {
-        // String copied failed
-        free(new_element);
+    // New element insert to list head
+    if (!q_push(head, new_element, true)) {
+        q_release_element(new_element);
         return false;
     }
 
-    // New element insert to list head
-    list_add(&new_element->list, head);
-
     return true;
 }
 
@@ -80,73 +422,283 @@ bool q_insert_tail(struct list_head *head, char *s)
     if (!head || !s)
         return false;
 
-    // Create a new element
-    element_t *new_element = malloc(sizeof(element_t));
+    // Create a new element holding a copy of s
+    element_t *new_element = q_new_element(head, s);
+    if (!new_element)
+        return false;
 
-    if (!new_element) {
+    // New element insert to list tail
+    if (!q_push(head, new_element, false)) {
+        q_release_element(new_element);
         return false;
     }
 
-    // Copy s to new element's value
-    new_element->value = strdup(s);
+    return true;
+}
 
-    // Check
-    if (!new_element->value) {
-        // String copied failed
-        free(new_element);
-        return false;
+/* Insert a batch of n elements carved out of a single block.
+ * Return n, or 0 if the block cannot be allocated or a string is NULL.
+ */
+static int q_insert_batch(struct list_head *head,
+                          char **sv,
+                          int n,
+                          bool at_head)
+{
+    size_t extra = 0;
+    for (int i = 0; i < n; i++) {
+        if (!sv[i])
+            return 0;
+        size_t len = strlen(sv[i]) + 1;
+        if (len > POOL_INLINE_LEN)
+            extra += len;
     }
-    // New element insert to list tail
-    list_add_tail(&new_element->list, head);
 
-    return true;
+    /* Make room in a ring first, so that pushing the batch cannot fail */
+    queue_t *q = q_header(head);
+    if (q->ring && !q->size) {
+        q->in_ring = true;
+        q->ring_first = 0;
+    }
+    while (q->in_ring && q->size + n > q->ring_capacity) {
+        if (!ring_grow(q))
+            return 0;
+    }
+
+    struct q_pool *batch =
+        malloc(sizeof(struct q_pool) + n * sizeof(pool_slot_t) + extra);
+    if (!batch)
+        return 0;
+
+    pool_slot_t *slots = (pool_slot_t *) (batch + 1);
+    char *strings = (char *) (slots + n);
+    batch->chunks = NULL;
+    INIT_LIST_HEAD(&batch->free_slots);
+    batch->live = n;
+    batch->orphan = true;
+    batch->strings = strings;
+    batch->strings_end = strings + extra;
+
+    LIST_HEAD(list);
+    for (int i = 0; i < n; i++) {
+        element_t *e = &slots[i].elem;
+        size_t len = strlen(sv[i]) + 1;
+        if (len > POOL_INLINE_LEN) {
+            e->value = memcpy(strings, sv[i], len);
+            strings += len;
+        } else {
+            e->value = memcpy(slots[i].inline_value, sv[i], len);
+        }
+        e->pool = batch;
+        e->key = prefix_key(sv[i]);
+        if (q->in_ring)
+            q_push(head, e, at_head);
+        else if (at_head)
+            list_add(&e->list, &list);
+        else
+            list_add_tail(&e->list, &list);
+    }
+
+    if (q->in_ring)
+        return n;
+    if (at_head)
+        list_splice(&list, head);
+    else
+        list_splice_tail(&list, head);
+    q->size += n;
+    return n;
 }
 
-/* Remove an element from head of queue */
-element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize)
+/* Insert as many of the n strings as possible, halving the batch whenever
+ * its block cannot be allocated.
+ */
+static int q_insert_bulk(struct list_head *head,
+                         char **sv,
+                         int n,
+                         bool at_head)
 {
-    // Is this queue empty
-    if (list_empty(head)) {
-        return NULL;
+    if (!head || !sv)
+        return 0;
+
+    /* A queue with a pool takes every element from it, so that the slots
+     * are recycled instead of malloc'ing a one-shot block per batch.
+     */
+    if (q_header(head)->pool) {
+        int done = 0;
+        while (done < n && (at_head ? q_insert_head(head, sv[done])
+                                    : q_insert_tail(head, sv[done])))
+            done++;
+        return done;
     }
 
+    int done = 0, batch = n;
+    while (done < n) {
+        if (batch > n - done)
+            batch = n - done;
+        if (q_insert_batch(head, sv + done, batch, at_head))
+            done += batch;
+        else if (batch > 1)
+            batch /= 2;
+        else
+            break;
+    }
+    return done;
+}
 
-    // Get first element from the queue
-    element_t *remove_element = list_first_entry(head, element_t, list);
+/* Insert an array of strings at head of queue */
+int q_insert_head_bulk(struct list_head *head, char **sv, int n)
+{
+    return q_insert_bulk(head, sv, n, true);
+}
 
-    if (remove_element) {
-        // Copy the value to sp
-        memcpy(sp, remove_element->value, bufsize);
-        sp[bufsize - 1] = '\0';
+/* Insert an array of strings at tail of queue */
+int q_insert_tail_bulk(struct list_head *head, char **sv, int n)
+{
+    return q_insert_bulk(head, sv, n, false);
+}
 
-        // Remove the element from the queue
-        list_del(&remove_element->list);
+/* Unlink the element at one end of the queue and copy its value into sp.
+ * Only the string itself is copied, never more than bufsize bytes, so short
+ * values cost a few bytes instead of the whole buffer.
+ */
+static element_t *q_take(struct list_head *head,
+                         bool at_head,
+                         char *sp,
+                         size_t bufsize)
+{
+    if (!head)
+        return NULL;
+
+    element_t *e = q_pop(head, at_head);
+    if (e && sp && bufsize) {
+        size_t len = strnlen(e->value, bufsize - 1);
+        memcpy(sp, e->value, len);
+        sp[len] = '\0';
     }
+    return e;
+}
 
-    return remove_element;
+/* Remove an element from head of queue */
+element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize)
+{
+    return q_take(head, true, sp, bufsize);
 }
 
 /* Remove an element from tail of queue */
 element_t *q_remove_tail(struct list_head *head, char *sp, size_t bufsize)
 {
-    // Is this queue empty
-    if (list_empty(head)) {
-        return NULL;
-    }
+    return q_take(head, false, sp, bufsize);
+}
+
+/* Remove an element from head of queue without copying its value */
+element_t *q_remove_head_nocopy(struct list_head *head, char **value)
+{
+    element_t *e = q_remove_head(head, NULL, 0);
+    if (value)
+        *value = e ? e->value : NULL;
+    return e;
+}
 
-    // Get first element from the queue
-    element_t *remove_element = list_last_entry(head, element_t, list);
+/* Remove an element from tail of queue without copying its value */
+element_t *q_remove_tail_nocopy(struct list_head *head, char **value)
+{
+    element_t *e = q_remove_tail(head, NULL, 0);
+    if (value)
+        *value = e ? e->value : NULL;
+    return e;
+}
 
-    if (remove_element) {
-        // Copy the value to sp
-        memcpy(sp, remove_element->value, bufsize);
-        sp[bufsize - 1] = '\0';
+/* Detach up to n elements at one end of the queue into out.
+ * The whole queue is spliced in O(1); otherwise exactly n nodes are walked
+ * from that end, so the cost depends on the batch and not on the queue.
+ */
+static int q_remove_n(struct list_head *head,
+                      struct list_head *out,
+                      int n,
+                      bool at_head)
+{
+    if (!head || !out || n <= 0 || !q_size(head))
+        return 0;
 
-        // Remove the element from the queue
-        list_del(&remove_element->list);
+    /* Ring queues hand out their elements one array slot at a time */
+    if (q_header(head)->in_ring) {
+        LIST_HEAD(batch);
+        int cnt = 0;
+        for (element_t *e; cnt < n && (e = q_pop(head, at_head)); cnt++) {
+            if (at_head)
+                list_add_tail(&e->list, &batch);
+            else
+                list_add(&e->list, &batch);
+        }
+        list_splice_tail(&batch, out);
+        return cnt;
+    }
+
+    queue_t *q = q_header(head);
+    if (n >= q->size) {
+        n = q->size;
+        list_splice_tail_init(head, out);
+        q->size = 0;
+        return n;
+    }
+
+    LIST_HEAD(batch);
+    if (at_head) {
+        struct list_head *last = head;
+        for (int i = 0; i < n; i++)
+            last = last->next;
+        list_cut_position(&batch, head, last);
+    } else {
+        struct list_head *first = head;
+        for (int i = 0; i < n; i++)
+            first = first->prev;
+        /* Move the tail segment [first, head->prev] into batch */
+        batch.next = first;
+        batch.prev = head->prev;
+        head->prev = first->prev;
+        first->prev->next = head;
+        first->prev = &batch;
+        batch.prev->next = &batch;
     }
+    list_splice_tail(&batch, out);
+    q->size -= n;
+    return n;
+}
+
+/* Remove up to n elements from head of queue */
+int q_remove_head_n(struct list_head *head, struct list_head *out, int n)
+{
+    return q_remove_n(head, out, n, true);
+}
+
+/* Remove up to n elements from tail of queue */
+int q_remove_tail_n(struct list_head *head, struct list_head *out, int n)
+{
+    return q_remove_n(head, out, n, false);
+}
+
+/* Return the element i positions from one end of the queue */
+element_t *q_peek(struct list_head *head, int i)
+{
+    if (!head)
+        return NULL;
 
-    return remove_element;
+    queue_t *q = q_header(head);
+    if (i < 0)
+        i += q->size;
+    if (i < 0 || i >= q->size)
+        return NULL;
+    if (q->in_ring)
+        return *ring_at(q, i);
+
+    struct list_head *node;
+    if (i < q->size / 2) {
+        for (node = head->next; i--;)
+            node = node->next;
+    } else {
+        for (node = head->prev; ++i < q->size;)
+            node = node->prev;
+    }
+    return list_entry(node, element_t, list);
 }
 
 /* Return number of elements in queue */
@@ -155,12 +707,7 @@ int q_size(struct list_head *head)
     if (!head)
         return 0;
 
-    int len = 0;
-    struct list_head *li;
-
-    list_for_each (li, head)
-        len++;
-    return len;
+    return q_header(head)->size;
 }
 
 /* Delete the middle node in queue */
@@ -168,8 +715,9 @@ bool q_delete_mid(struct list_head *head)
 {
     // https://leetcode.com/problems/delete-the-middle-node-of-a-linked-list/
 
+    q_flatten(head);
     // Is this a empty queue
-    if (!head)
+    if (!head || list_empty(head))
         return false;
 
     // Use fast and slow pointer
@@ -190,6 +738,7 @@ bool q_delete_mid(struct list_head *head)
 
     // Delete middle node from the queue
     list_del(slow->next);
+    q_header(head)->size--;
     q_release_element(mid);
 
     return true;
@@ -200,6 +749,7 @@ bool q_delete_dup(struct list_head *head)
 {
     // https://leetcode.com/problems/remove-duplicates-from-sorted-list-ii/
 
+    q_flatten(head);
     // If queue is empty or one node, we can return true
     if (!head)
         return false;
@@ -208,18 +758,19 @@ bool q_delete_dup(struct list_head *head)
 
     // If the queue have duplicate value, this value will become true
     bool dup = false;
+    queue_t *q = q_header(head);
     element_t *cur, *next;
     list_for_each_entry_safe (cur, next, head, list) {
         if (&next->list != head && strcmp(cur->value, next->value) == 0) {
             dup = true;
             list_del(&cur->list);
-            free(cur->value);
-            free(cur);
+            q->size--;
+            q_release_element(cur);
         } else if (dup) {
             dup = false;
             list_del(&cur->list);
-            free(cur->value);
-            free(cur);
+            q->size--;
+            q_release_element(cur);
         }
     }
 
@@ -227,11 +778,79 @@ bool q_delete_dup(struct list_head *head)
     return true;
 }
 
+/* Open-addressing entry of the duplicate table, one per distinct string */
+typedef struct {
+    uint64_t hash;
+    element_t *first; /* First occurrence, NULL for an empty entry */
+    bool dup;
+} dup_entry_t;
+
+/* 64-bit FNV-1a string hash */
+static inline uint64_t str_hash(const char *s)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s)
+        h = (h ^ (unsigned char) *s++) * 0x100000001b3ULL;
+    return h;
+}
+
+/* Delete duplicate strings from an unsorted queue */
+bool q_delete_dup_unsorted(struct list_head *head, bool keep_first)
+{
+    q_flatten(head);
+    if (!head)
+        return false;
+    if (list_empty(head) || list_is_singular(head))
+        return true;
+
+    queue_t *q = q_header(head);
+    size_t cap = 16;
+    while (cap < (size_t) q->size * 2)
+        cap <<= 1;
+    dup_entry_t *table = malloc(cap * sizeof(dup_entry_t));
+    if (!table)
+        return false;
+    memset(table, 0, cap * sizeof(dup_entry_t));
+
+    /* Later occurrences go right away, first ones are only marked */
+    element_t *cur, *next;
+    list_for_each_entry_safe (cur, next, head, list) {
+        uint64_t h = str_hash(cur->value);
+        size_t i = h & (cap - 1);
+        while (table[i].first && (table[i].hash != h ||
+                                  strcmp(table[i].first->value, cur->value)))
+            i = (i + 1) & (cap - 1);
+        if (!table[i].first) {
+            table[i].hash = h;
+            table[i].first = cur;
+            continue;
+        }
+        table[i].dup = true;
+        list_del(&cur->list);
+        q->size--;
+        q_release_element(cur);
+    }
+
+    if (!keep_first) {
+        for (size_t i = 0; i < cap; i++) {
+            if (!table[i].dup)
+                continue;
+            list_del(&table[i].first->list);
+            q->size--;
+            q_release_element(table[i].first);
+        }
+    }
+
+    free(table);
+    return true;
+}
+
 /* Swap every two adjacent nodes */
 void q_swap(struct list_head *head)
 {
     // https://leetcode.com/problems/swap-nodes-in-pairs/
 
+    q_flatten(head);
     if (!head || !head->next)
         return;
 
@@ -247,6 +866,7 @@ void q_swap(struct list_head *head)
 /* Reverse elements in queue */
 void q_reverse(struct list_head *head)
 {
+    q_flatten(head);
     if (!head || list_empty(head))
         return;
     struct list_head *current = NULL;
@@ -261,44 +881,101 @@ void q_reverse(struct list_head *head)
     current->prev = next;
 }
 
-/* Reverse the nodes of the list k at a time */
+/* Reverse the nodes of the list k at a time, in a single pass.
+ * Each group is reversed as it is walked, by swapping next and prev of its
+ * nodes, and then spliced back between its neighbours.  A final group found
+ * to be short is swapped back the same way.
+ */
 void q_reverseK(struct list_head *head, int k)
 {
     // https://leetcode.com/problems/reverse-nodes-in-k-group/
 
-    if (!head || list_empty(head))
+    q_flatten(head);
+    if (!head || list_empty(head) || k < 2)
         return;
-    struct list_head *current = NULL;
-    struct list_head *next = NULL;
-    struct list_head *reverseHead = head;
-
-    // Get number of group
-    int num = q_size(head) / k;
-    int count = k - 1;
 
-    for (; num != 0; num--) {
-        current = reverseHead->next;
-        next = current->next;
+    struct list_head *before = head, *node = head->next;
+    while (node != head) {
+        struct list_head *first = node;
+        int n = 0;
+        for (; n < k && node != head; n++) {
+            struct list_head *next = node->next;
+            node->next = node->prev;
+            node->prev = next;
+            node = next;
+        }
 
-        for (; count != 0; count--) {
-            list_del(next);
-            list_add(next, reverseHead);
-            next = current->next;
+        /* node follows the group and still links back to its last node */
+        struct list_head *last = node->prev;
+        if (n < k) {
+            for (struct list_head *cur = first; cur != node;) {
+                struct list_head *next = cur->prev;
+                cur->prev = cur->next;
+                cur->next = next;
+                cur = next;
+            }
+            return;
         }
-        reverseHead = current;
-        count = k - 1;
+
+        last->prev = before;
+        before->next = last;
+        first->next = node;
+        node->prev = first;
+        before = first;
     }
 }
 
-int cmp(const char *a, const char *b, bool descend)
+/* Whether cmp() may order elements by their prefix keys */
+static bool prefix_enabled = true;
+
+void q_use_prefix_key(bool enable)
+{
+    prefix_enabled = enable;
+}
+
+/* Comparisons made by cmp() while counting them */
+static bool count_compares = false;
+static atomic_ulong compares;
+
+void q_count_compares(bool enable)
+{
+    atomic_store(&compares, 0);
+    count_compares = enable;
+}
+
+unsigned long q_compares(void)
+{
+    return atomic_load(&compares);
+}
+
+/* Compare two elements in sorting order.
+ * The prefix keys decide most comparisons without touching the strings.
+ * Equal keys with a zero last byte mean both strings ended within the
+ * prefix, so they are equal; otherwise strcmp() resumes after the prefix.
+ */
+static int cmp(const element_t *a, const element_t *b, bool descend)
 {
+    if (count_compares)
+        atomic_fetch_add_explicit(&compares, 1, memory_order_relaxed);
     if (descend) {
-        return (strcmp(b, a));
-    } else {
-        return (strcmp(a, b));
+        const element_t *tmp = a;
+        a = b;
+        b = tmp;
     }
+
+    if (!prefix_enabled)
+        return strcmp(a->value, b->value);
+    if (a->key != b->key)
+        return (a->key > b->key) - (a->key < b->key);
+    if (!(a->key & 0xff))
+        return 0;
+    return strcmp(a->value + 8, b->value + 8);
 }
 
+/* Merge two sorted lists onto the tail of @result.
+ * On ties the element of @first_list goes first, so the merge is stable
+ * when @first_list held the earlier elements.
+ */
 void merge_list(struct list_head *result,
                 struct list_head *first_list,
                 struct list_head *second_list,
@@ -310,7 +987,7 @@ void merge_list(struct list_head *result,
             list_entry(first_list->next, element_t, list);
         element_t *second_element =
             list_entry(second_list->next, element_t, list);
-        if (cmp(first_element->value, second_element->value, descend) < 0) {
+        if (cmp(first_element, second_element, descend) <= 0) {
             list_move_tail(first_list->next, result);
         } else {
             list_move_tail(second_list->next, result);
@@ -325,66 +1002,616 @@ void merge_list(struct list_head *result,
     }
 }
 
-void merge_sort(struct list_head *head, bool descend)
+/* Merge two null-terminated runs linked through their next pointers only.
+ * On ties the element of @a goes first, so the merge is stable.
+ */
+static struct list_head *merge_runs(struct list_head *a,
+                                    struct list_head *b,
+                                    bool descend)
 {
-    if (!head || list_empty(head) || list_is_singular(head))
-        return;
+    struct list_head *head = NULL, **tail = &head;
+
+    for (;;) {
+        if (cmp(list_entry(a, element_t, list), list_entry(b, element_t, list),
+                descend) <= 0) {
+            *tail = a;
+            tail = &a->next;
+            a = a->next;
+            if (!a) {
+                *tail = b;
+                break;
+            }
+        } else {
+            *tail = b;
+            tail = &b->next;
+            b = b->next;
+            if (!b) {
+                *tail = a;
+                break;
+            }
+        }
+    }
+    return head;
+}
 
-    // Use fast and slow pointer
-    struct list_head *slow, *fast;
-    for (slow = head->next, fast = slow; fast != head && fast->next != head;
-         fast = fast->next->next) {
-        slow = slow->next;
+/* Runs shorter than this are extended by insertion, as in Timsort, so that
+ * random input does not degenerate into merging runs of one or two nodes.
+ */
+#define MIN_RUN 8
+
+/* Detach the run starting at @list.
+ * A descending run, which starts with a strict descent, is reversed in
+ * place so that every run comes out in sorting order.  Elements equal to
+ * each other within it are reversed as a group, keeping their original
+ * order, so that duplicates do not cut the run short.  Short runs are then
+ * extended to MIN_RUN nodes by stable insertion.  The rest of the list is
+ * returned through @rest.
+ */
+static struct list_head *find_run(struct list_head *list,
+                                  struct list_head **rest,
+                                  size_t *len,
+                                  bool descend)
+{
+    struct list_head *run = list, *tail = list;
+    struct list_head *next = list->next;
+    size_t n = 1;
+
+    if (next && cmp(list_entry(next, element_t, list),
+                    list_entry(list, element_t, list), descend) < 0) {
+        /* Descending: push each group of equal elements, still linked in
+         * their original order, on the front of the reversed run.
+         */
+        struct list_head *group = list, *last = list;
+        run = NULL;
+        do {
+            if (cmp(list_entry(next, element_t, list),
+                    list_entry(last, element_t, list), descend) < 0) {
+                last->next = run;
+                run = group;
+                group = next;
+            }
+            last = next;
+            next = next->next;
+            n++;
+        } while (next && cmp(list_entry(next, element_t, list),
+                             list_entry(last, element_t, list), descend) <= 0);
+        last->next = run;
+        run = group;
+    } else {
+        /* Ascending (non-strict) */
+        while (next && cmp(list_entry(next, element_t, list),
+                           list_entry(tail, element_t, list), descend) >= 0) {
+            tail = next;
+            next = next->next;
+            n++;
+        }
+    }
+    tail->next = NULL;
+
+    for (; next && n < MIN_RUN; n++) {
+        struct list_head *node = next;
+        const element_t *e = list_entry(node, element_t, list);
+        next = next->next;
+
+        /* Insert after every element that is not greater than node */
+        struct list_head **pos = &run;
+        while (*pos && cmp(list_entry(*pos, element_t, list), e, descend) <= 0)
+            pos = &(*pos)->next;
+        node->next = *pos;
+        *pos = node;
+    }
+
+    *rest = next;
+    *len = n;
+    return run;
+}
+
+/* Maximum number of pending runs.  The merge rules below keep run lengths
+ * growing at least as fast as the Fibonacci numbers from the top of the stack
+ * to the bottom, so 64 entries are plenty for any queue that fits in memory.
+ */
+#define MAX_PENDING 64
+
+typedef struct {
+    struct list_head *list;
+    size_t len;
+} run_t;
+
+/* Merge pending runs i and i + 1 into slot i */
+static void merge_at(run_t *pending, int *npending, int i, bool descend)
+{
+    pending[i].list =
+        merge_runs(pending[i].list, pending[i + 1].list, descend);
+    pending[i].len += pending[i + 1].len;
+    if (i + 2 < *npending)
+        pending[i + 1] = pending[i + 2];
+    (*npending)--;
+}
+
+/* Natural bottom-up merge sort.
+ * Existing runs are detected and pushed on a small stack of pending runs,
+ * which are merged following the Timsort rules so that merges stay
+ * balanced.  No recursion and no allocation: only next pointers are used
+ * while sorting, and prev pointers are rebuilt in one final pass.
+ */
+static void merge_sort(struct list_head *head, bool descend)
+{
+    run_t pending[MAX_PENDING];
+    int npending = 0;
+
+    /* Break the circular list into a null-terminated one */
+    struct list_head *list = head->next;
+    head->prev->next = NULL;
+
+    while (list) {
+        size_t len;
+        pending[npending].list = find_run(list, &list, &len, descend);
+        pending[npending].len = len;
+        npending++;
+
+        while (npending > 1) {
+            int i = npending - 2;
+            if ((i > 0 &&
+                 pending[i - 1].len <= pending[i].len + pending[i + 1].len) ||
+                (i > 1 &&
+                 pending[i - 2].len <= pending[i - 1].len + pending[i].len)) {
+                if (pending[i - 1].len < pending[i + 1].len)
+                    i--;
+            } else if (pending[i].len > pending[i + 1].len) {
+                break;
+            }
+            merge_at(pending, &npending, i, descend);
+        }
+    }
+
+    while (npending > 1)
+        merge_at(pending, &npending, npending - 2, descend);
+
+    /* Restore the prev links and make the list circular again */
+    struct list_head *prev = head;
+    for (list = pending[0].list; list; list = list->next) {
+        prev->next = list;
+        list->prev = prev;
+        prev = list;
+    }
+    prev->next = head;
+    head->prev = prev;
+}
+
+/* Whether sorting buckets elements by byte instead of merging them */
+static bool radix_enabled = false;
+
+void q_use_radix_sort(bool enable)
+{
+    radix_enabled = enable;
+}
+
+#define RADIX_BUCKETS 256
+
+/* Buckets smaller than this are merge sorted rather than split again */
+#define RADIX_MIN_BUCKET 32
+
+/* Byte of an element's value at a depth where it has not ended yet */
+static inline unsigned char radix_byte(const element_t *e, int depth)
+{
+    if (depth < 8)
+        return e->key >> (56 - 8 * depth);
+    return e->value[depth];
+}
+
+/* MSD radix sort of the elements at head, which agree on their first depth
+ * bytes.  Nodes are moved into one bucket list per byte value and the
+ * buckets spliced back in order, without touching the strings beyond the
+ * byte that decides; within the prefix key, not even that.  Bucket 0 holds
+ * strings that end here, which are equal and need no more work.  Small
+ * buckets are merge sorted.  Each round recurses into all but the largest
+ * bucket, each at most half the elements, and goes on splitting the largest
+ * one itself, so the recursion stays O(log n) deep.  Moving nodes only
+ * between lists keeps the sort stable.
+ */
+static void radix_sort(struct list_head *head,
+                       int size,
+                       int depth,
+                       bool descend)
+{
+    struct list_head buckets[RADIX_BUCKETS];
+    int counts[RADIX_BUCKETS];
+    LIST_HEAD(todo);
+    struct list_head *at = head;
+
+    list_splice_init(head, &todo);
+    while (size >= RADIX_MIN_BUCKET) {
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            INIT_LIST_HEAD(&buckets[b]);
+            counts[b] = 0;
+        }
+        struct list_head *node, *safe;
+        list_for_each_safe (node, safe, &todo) {
+            unsigned char b =
+                radix_byte(list_entry(node, element_t, list), depth);
+            list_move_tail(node, &buckets[b]);
+            counts[b]++;
+        }
+
+        int largest = 0, most = 0;
+        for (int b = 1; b < RADIX_BUCKETS; b++) {
+            if (counts[b] > most) {
+                most = counts[b];
+                largest = b;
+            }
+        }
+
+        /* Gather this level after at, leaving a gap for the largest */
+        LIST_HEAD(level);
+        struct list_head *gap = NULL;
+        for (int i = 0; i < RADIX_BUCKETS; i++) {
+            int b = descend ? RADIX_BUCKETS - 1 - i : i;
+            if (b && b == largest) {
+                gap = level.prev;
+                continue;
+            }
+            if (counts[b] > 1 && b)
+                radix_sort(&buckets[b], counts[b], depth + 1, descend);
+            list_splice_tail(&buckets[b], &level);
+        }
+        if (gap == &level)
+            gap = at;
+        list_splice(&level, at);
+        if (!largest)
+            return;
+
+        at = gap;
+        list_splice_init(&buckets[largest], &todo);
+        size = most;
+        depth++;
+    }
+
+    if (size > 1)
+        merge_sort(&todo, descend);
+    list_splice(&todo, at);
+}
+
+/* Sort a list with the sorting algorithm selected */
+static void sort_list(struct list_head *head, bool descend)
+{
+    if (radix_enabled)
+        radix_sort(head, INT_MAX, 0, descend);
+    else
+        merge_sort(head, descend);
+}
+
+#define MAX_SORT_THREADS 16
+
+/* Below this many elements per thread, sorting in parallel does not pay */
+#define MIN_PARALLEL_SEGMENT 4096
+
+/* Number of threads q_sort() may use */
+static int sort_threads = 1;
+
+void q_set_sort_threads(int n)
+{
+    sort_threads = n < 1 ? 1 : n > MAX_SORT_THREADS ? MAX_SORT_THREADS : n;
+}
+
+/* Sort @first when @second is NULL, otherwise merge @second into @first */
+typedef struct {
+    struct list_head *first, *second;
+    bool descend;
+} sort_task_t;
+
+static void *sort_worker(void *arg)
+{
+    sort_task_t *task = arg;
+
+    if (!task->second) {
+        sort_list(task->first, task->descend);
+        return NULL;
+    }
+
+    LIST_HEAD(result);
+    merge_list(&result, task->first, task->second, task->descend);
+    list_splice(&result, task->first);
+    return NULL;
+}
+
+/* Run every task on a thread of its own, except the last one, which runs
+ * on the calling thread.  Every worker is joined before returning.
+ */
+static void run_sort_tasks(sort_task_t *tasks, int n)
+{
+    pthread_t tid[MAX_SORT_THREADS];
+    bool started[MAX_SORT_THREADS];
+
+    for (int i = 0; i < n - 1; i++)
+        started[i] =
+            pthread_create(&tid[i], NULL, sort_worker, &tasks[i]) == 0;
+
+    sort_worker(&tasks[n - 1]);
+    for (int i = 0; i < n - 1; i++) {
+        if (started[i])
+            pthread_join(tid[i], NULL);
+        else
+            sort_worker(&tasks[i]);
+    }
+}
+
+/* Cut the queue into one segment per thread, sort the segments
+ * concurrently and merge them pairwise, with the merges of each round also
+ * running concurrently.  All bookkeeping lives on the stack.
+ *
+ * SIGALRM stays blocked until the segments are back in the queue, and the
+ * workers inherit the mask.  The time limit of qtest jumps out of the
+ * thread that armed it, which would otherwise abandon this frame while the
+ * workers still splice nodes through it.  An alarm that expires meanwhile
+ * is delivered once the queue is whole again.
+ */
+static void parallel_sort(struct list_head *head,
+                          int size,
+                          int nthreads,
+                          bool descend)
+{
+    struct list_head segs[MAX_SORT_THREADS];
+    sort_task_t tasks[MAX_SORT_THREADS];
+    sigset_t block, old;
+
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+
+    for (int i = 0; i < nthreads; i++) {
+        INIT_LIST_HEAD(&segs[i]);
+        if (i == nthreads - 1) {
+            list_splice_init(head, &segs[i]);
+        } else {
+            struct list_head *pos = head;
+            for (int n = size / nthreads; n; n--)
+                pos = pos->next;
+            list_cut_position(&segs[i], head, pos);
+        }
+        tasks[i] = (sort_task_t){&segs[i], NULL, descend};
     }
-    // Split
-    LIST_HEAD(left_head);
-    LIST_HEAD(mid_head);
-    list_cut_position(&left_head, head, slow->prev);
-    list_splice(head, &mid_head);
-    INIT_LIST_HEAD(head);
+    run_sort_tasks(tasks, nthreads);
 
-    merge_sort(&left_head, descend);
-    merge_sort(&mid_head, descend);
-    // Merge
-    merge_list(head, &left_head, &mid_head, descend);
+    for (int step = 1; step < nthreads; step *= 2) {
+        int n = 0;
+        for (int i = 0; i + step < nthreads; i += 2 * step)
+            tasks[n++] = (sort_task_t){&segs[i], &segs[i + step], descend};
+        run_sort_tasks(tasks, n);
+    }
+    list_splice(&segs[0], head);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
 }
 
+/* Finish sorting in O(n) when the list is already ordered either way.
+ * One pass compares neighbours until the list proves to be neither
+ * non-decreasing nor non-increasing, which takes a few steps on random
+ * input.  A sorted list is left alone.  A reverse-sorted one has its groups
+ * of equal elements moved to the front one by one, which reverses their
+ * order but keeps the order within each group, as a stable sort must.
+ * Return false, with the list untouched, when it is neither.
+ */
+static bool sort_presorted(struct list_head *head, bool descend)
+{
+    bool up = true, down = true;
+    for (struct list_head *node = head->next; node->next != head;
+         node = node->next) {
+        int c = cmp(list_entry(node->next, element_t, list),
+                    list_entry(node, element_t, list), descend);
+        if (c < 0)
+            up = false;
+        else if (c > 0)
+            down = false;
+        if (!up && !down)
+            return false;
+    }
+    if (up)
+        return true;
+
+    LIST_HEAD(reversed);
+    while (!list_empty(head)) {
+        struct list_head *first = head->next, *last = first;
+        while (last->next != head &&
+               !cmp(list_entry(last->next, element_t, list),
+                    list_entry(first, element_t, list), descend))
+            last = last->next;
+
+        LIST_HEAD(group);
+        list_cut_position(&group, head, last);
+        list_splice(&group, &reversed);
+    }
+    list_splice(&reversed, head);
+    return true;
+}
 
 /* Sort elements of queue in ascending/descending order */
 void q_sort(struct list_head *head, bool descend)
 {
-    if (!head || list_empty(head))
+    q_flatten(head);
+    if (!head || list_empty(head) || list_is_singular(head))
         return;
-    merge_sort(head, descend);
+
+    if (!sort_presorted(head, descend)) {
+        int size = q_size(head);
+        int nthreads = sort_threads;
+        if (nthreads > size / MIN_PARALLEL_SEGMENT)
+            nthreads = size / MIN_PARALLEL_SEGMENT;
+        if (nthreads > 1)
+            parallel_sort(head, size, nthreads, descend);
+        else
+            sort_list(head, descend);
+    }
+}
+
+/* Below this many elements, selection sorts what is left instead */
+#define SELECT_SORT_BELOW 16
+
+/* Append an element to a partition, keeping @mid on its middle element */
+static inline void select_add(struct list_head *node,
+                              struct list_head *part,
+                              struct list_head **mid,
+                              int *n)
+{
+    list_move_tail(node, part);
+    if (++*n == 1)
+        *mid = node;
+    else if (*n & 1)
+        *mid = (*mid)->next;
+}
+
+static inline element_t *median3(element_t *a,
+                                 element_t *b,
+                                 element_t *c,
+                                 bool descend)
+{
+    if (cmp(a, b, descend) > 0) {
+        element_t *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    if (cmp(b, c, descend) <= 0)
+        return b;
+    return cmp(a, c, descend) > 0 ? a : c;
+}
+
+/* Move the element of rank k among the size elements at head to position
+ * k, with smaller elements ahead of it and larger ones after it.
+ * Three-way partitioning around a median of three moves elements ordered
+ * before the pivot to one list and elements ordered after it to another,
+ * both in their original order, so that sorted stretches stay sorted and
+ * the middle of each partition is tracked as it fills up.  Only the range
+ * that still holds rank k is partitioned again; the ranges settled on
+ * either side are set aside and spliced back at the end.  After about
+ * twice log2(size) rounds without finding the element, the range is sorted.
+ */
+static element_t *quickselect(struct list_head *head,
+                              int size,
+                              int k,
+                              bool descend)
+{
+    LIST_HEAD(before);
+    LIST_HEAD(after);
+    element_t *found = NULL;
+
+    struct list_head *mid = head->next;
+    for (int i = 0; i < (size - 1) / 2; i++)
+        mid = mid->next;
+
+    int rounds = 4;
+    for (int n = size; n > 1; n >>= 1)
+        rounds += 2;
+
+    while (!found) {
+        if (size < SELECT_SORT_BELOW || !rounds--) {
+            merge_sort(head, descend);
+            struct list_head *node = head->next;
+            while (k--)
+                node = node->next;
+            found = list_entry(node, element_t, list);
+            break;
+        }
+
+        element_t *pivot = median3(list_first_entry(head, element_t, list),
+                                   list_entry(mid, element_t, list),
+                                   list_last_entry(head, element_t, list),
+                                   descend);
+        LIST_HEAD(less);
+        LIST_HEAD(greater);
+        struct list_head *mid_less = NULL, *mid_greater = NULL;
+        int nless = 0, ngreater = 0;
+        struct list_head *node, *safe;
+        list_for_each_safe (node, safe, head) {
+            int c = cmp(list_entry(node, element_t, list), pivot, descend);
+            if (c < 0)
+                select_add(node, &less, &mid_less, &nless);
+            else if (c > 0)
+                select_add(node, &greater, &mid_greater, &ngreater);
+        }
+
+        /* What is left in head compares equal to the pivot */
+        int nequal = size - nless - ngreater;
+        if (k < nless) {
+            list_splice_tail_init(&greater, &after);
+            list_splice_init(head, &after);
+            list_splice_init(&less, head);
+            size = nless;
+            mid = mid_less;
+        } else if (k >= nless + nequal) {
+            list_splice_tail_init(&less, &before);
+            list_splice_tail_init(head, &before);
+            list_splice_init(&greater, head);
+            k -= nless + nequal;
+            size = ngreater;
+            mid = mid_greater;
+        } else {
+            node = head->next;
+            for (k -= nless; k; k--)
+                node = node->next;
+            found = list_entry(node, element_t, list);
+            list_splice_init(&less, head);
+            list_splice_tail_init(&greater, head);
+        }
+    }
+
+    list_splice(&before, head);
+    list_splice_tail(&after, head);
+    return found;
+}
+
+element_t *q_select_kth(struct list_head *head, int k, bool descend)
+{
+    q_flatten(head);
+    if (!head || k < 0 || k >= q_size(head))
+        return NULL;
+    return quickselect(head, q_size(head), k, descend);
+}
+
+int q_top_k(struct list_head *head, int k, bool descend)
+{
+    q_flatten(head);
+    int size = q_size(head);
+    if (k <= 0 || !size)
+        return 0;
+    if (k >= size) {
+        q_sort(head, descend);
+        return size;
+    }
+
+    /* Everything up to the element of rank k - 1 belongs to the top k */
+    element_t *last = quickselect(head, size, k - 1, descend);
+    LIST_HEAD(top);
+    list_cut_position(&top, head, &last->list);
+    merge_sort(&top, descend);
+    list_splice(&top, head);
+    return k;
 }
 
 int q_descend_or_ascend(struct list_head *head, bool descend)
 {
+    q_flatten(head);
     if (!head || list_empty(head))
         return 0;
 
     int num = 0;
     struct list_head *cur = head->prev;
-    char *max = list_entry(cur, element_t, list)->value;
+    const element_t *max = list_entry(cur, element_t, list);
     cur = cur->prev;
     while (cur != head) {
         num++;
         element_t *cur_element = list_entry(cur, element_t, list);
-        bool del_prev = cmp(max, cur_element->value, descend) < 0;
+        bool del_prev = cmp(max, cur_element, descend) < 0;
         if (del_prev) {
             struct list_head *tmp = cur;
             cur = cur->prev;
             list_del(tmp);
-            element_t *tmp_ele = list_entry(tmp, element_t, list);
-            free(tmp_ele->value);
-            free(tmp_ele);
+            q_release_element(list_entry(tmp, element_t, list));
             num--;
         } else {
-            max = cur_element->value;
+            max = cur_element;
             cur = cur->prev;
         }
     }
     num++;
+    q_header(head)->size = num;
     return num;
 }
 
@@ -406,32 +1633,131 @@ int q_descend(struct list_head *head)
 
 
 
+/* Whether the first element of queue a goes before the first one of b.
+ * Ties go to the queue that comes first in the chain, keeping the merge
+ * stable.
+ */
+static inline bool queue_before(const queue_t *a,
+                                const queue_t *b,
+                                bool descend)
+{
+    int c = cmp(list_first_entry(&a->head, element_t, list),
+                list_first_entry(&b->head, element_t, list), descend);
+    return c < 0 || (c == 0 && a->rank < b->rank);
+}
+
+/* Meld two pairing heaps of non-empty queues keyed by their first element */
+static queue_t *heap_meld(queue_t *a, queue_t *b, bool descend)
+{
+    if (!a)
+        return b;
+    if (!b)
+        return a;
+    if (queue_before(b, a, descend)) {
+        queue_t *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->sibling = a->child;
+    a->child = b;
+    return a;
+}
+
+/* Remove the root of a pairing heap with the usual two-pass pairing */
+static queue_t *heap_pop(queue_t *root, bool descend)
+{
+    queue_t *pairs = NULL;
+
+    /* First pass: meld children in pairs, left to right */
+    for (queue_t *a = root->child; a;) {
+        queue_t *b = a->sibling, *next = b ? b->sibling : NULL;
+        a->sibling = NULL;
+        if (b)
+            b->sibling = NULL;
+        a = heap_meld(a, b, descend);
+        a->sibling = pairs;
+        pairs = a;
+        a = next;
+    }
+
+    /* Second pass: meld the pairs back together, right to left */
+    queue_t *heap = NULL;
+    while (pairs) {
+        queue_t *next = pairs->sibling;
+        pairs->sibling = NULL;
+        heap = heap_meld(heap, pairs, descend);
+        pairs = next;
+    }
+    return heap;
+}
+
 /* Merge all the queues into one sorted queue, which is in ascending/descending
- * order */    /* code */
-// https://github.com/ShawnXuanc/lab0-c/blob/master/queue.c
+ * order.
+ * The non-empty queues form a pairing heap keyed by their first element,
+ * linked through their headers so that nothing is allocated.  Each round
+ * takes the queue with the smallest head and moves, in one splice, every
+ * element of it that goes before the head of the next best queue, so the
+ * cost is O(N log k) comparisons at worst and much less for clustered input.
+ */
 int q_merge(struct list_head *head, bool descend)
 {
     // https://leetcode.com/problems/merge-k-sorted-lists/
     if (!head || list_empty(head))
         return 0;
 
-    int size = 0;
+    queue_contex_t *first = list_first_entry(head, queue_contex_t, chain);
+    if (!first->q)
+        return 0;
+
+    int size = 0, rank = 0;
+    queue_t *heap = NULL;
+    queue_contex_t *ctx;
+    list_for_each_entry (ctx, head, chain) {
+        if (!ctx->q)
+            continue;
+        q_flatten(ctx->q);
+        queue_t *q = q_header(ctx->q);
+        size += q->size;
+        q->size = 0;
+        if (list_empty(&q->head))
+            continue;
+        q->child = q->sibling = NULL;
+        q->rank = rank++;
+        heap = heap_meld(heap, q, descend);
+    }
+
     LIST_HEAD(result);
-    INIT_LIST_HEAD(&result);
+    while (heap) {
+        queue_t *q = heap;
+        heap = heap_pop(q, descend);
+        if (!heap) {
+            list_splice_tail_init(&q->head, &result);
+            break;
+        }
 
-    struct list_head *list_next = head->next->next;
-    struct list_head *first = head->next;
-    while (list_next != head) {
-        queue_contex_t *first_context =
-            list_entry(first, queue_contex_t, chain);
-        queue_contex_t *contex_next =
-            list_entry(list_next, queue_contex_t, chain);
-        size += contex_next->size;
+        /* The head of q goes first; extend the run as far as it can go */
+        const element_t *limit =
+            list_first_entry(&heap->head, element_t, list);
+        struct list_head *last = q->head.next;
+        while (last->next != &q->head) {
+            int c =
+                cmp(list_entry(last->next, element_t, list), limit, descend);
+            if (c > 0 || (c == 0 && q->rank > heap->rank))
+                break;
+            last = last->next;
+        }
 
-        merge_list(&result, first_context->q, contex_next->q, descend);
-        list_splice_init(&result, first_context->q);
-        list_next = list_next->next;
+        LIST_HEAD(run);
+        list_cut_position(&run, &q->head, last);
+        list_splice_tail(&run, &result);
+
+        if (!list_empty(&q->head)) {
+            q->child = q->sibling = NULL;
+            heap = heap_meld(heap, q, descend);
+        }
     }
 
+    list_splice(&result, first->q);
+    q_header(first->q)->size = size;
     return size;
 }
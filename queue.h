@@ -9,20 +9,29 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "harness.h"
 #include "list.h"
 
+struct q_pool;
+
 /**
  * element_t - Linked list element
  * @value: pointer to array holding string
  * @list: node of a doubly-linked list
+ * @pool: element pool this element was carved from, NULL if malloc'ed
+ * @key: first eight bytes of @value packed in big-endian order, so that
+ *       most comparisons can be decided without dereferencing @value
  *
- * @value needs to be explicitly allocated and freed
+ * @value needs to be explicitly allocated and freed, unless the element
+ * comes from a pool and the string is short enough to be stored inline.
  */
 typedef struct {
     char *value;
     struct list_head list;
+    uint64_t key;
+    struct q_pool *pool;
 } element_t;
 
 /**
@@ -48,6 +57,63 @@ typedef struct {
  */
 struct list_head *q_new();
 
+/**
+ * q_use_pool() - Select the allocation strategy for queues created afterwards
+ * @enable: whether q_new() should attach a per-queue element pool
+ *
+ * A pooled queue carves its elements out of large chunks instead of doing
+ * one malloc for the node and one for the string, and stores short strings
+ * in the same slot as the node.
+ */
+void q_use_pool(bool enable);
+
+/**
+ * q_use_ring() - Select the backend of queues created afterwards
+ * @enable: whether q_new() should create a ring deque
+ *
+ * A ring deque keeps pointers to its elements in a growable circular array,
+ * so insertion and removal at both ends touch a single array slot instead of
+ * the neighbouring nodes.  The elements are linked into the list only when
+ * another operation needs it, see q_flatten().
+ */
+void q_use_ring(bool enable);
+
+/**
+ * q_flatten() - Make sure the elements of a queue are linked through head
+ * @head: header of queue
+ *
+ * Converts a ring deque to list form, without allocating or freeing memory.
+ * All queue operations do so on their own when they need the list; callers
+ * walking the list themselves must call this first.  A queue goes back to
+ * the ring form once it is drained.  No effect on other queues.
+ */
+void q_flatten(struct list_head *head);
+
+/**
+ * q_use_prefix_key() - Select how elements are compared when ordering them
+ * @enable: compare the prefix keys first and call strcmp() only on a tie
+ *
+ * Enabled by default.  Disabling it makes every comparison call strcmp().
+ */
+void q_use_prefix_key(bool enable);
+
+/**
+ * q_count_compares() - Start or stop counting comparisons between elements
+ * @enable: whether to count from now on
+ *
+ * Every comparison made to order elements is counted, by sorting,
+ * selection and merging alike, including on the threads of a parallel
+ * sort.  The count starts again from zero.
+ */
+void q_count_compares(bool enable);
+
+/**
+ * q_compares() - Get the number of comparisons counted
+ *
+ * Return: comparisons made since q_count_compares() was last called
+ */
+unsigned long q_compares(void);
+
 /**
  * q_free() - Free all storage used by queue, no effect if header is NULL
  * @head: header of queue
@@ -78,6 +144,35 @@ bool q_insert_head(struct list_head *head, char *s);
  */
 bool q_insert_tail(struct list_head *head, char *s);
 
+/**
+ * q_insert_head_bulk() - Insert an array of strings at the head
+ * @head: header of queue
+ * @sv: array of strings would be inserted
+ * @n: number of strings in @sv
+ *
+ * The queue ends up as if q_insert_head() had been called on sv[0], sv[1],
+ * ... in turn.  Elements and string copies of a whole batch share one
+ * allocation and are linked into the queue with a single splice.  When that
+ * allocation fails, the batch is split and retried, so a prefix of @sv may
+ * still be inserted.  Insertion stops at the first NULL string.
+ *
+ * Return: the number of strings inserted, from 0 to @n
+ */
+int q_insert_head_bulk(struct list_head *head, char **sv, int n);
+
+/**
+ * q_insert_tail_bulk() - Insert an array of strings at the tail
+ * @head: header of queue
+ * @sv: array of strings would be inserted
+ * @n: number of strings in @sv
+ *
+ * The queue ends up as if q_insert_tail() had been called on sv[0], sv[1],
+ * ... in turn.  See q_insert_head_bulk() for allocation and failure.
+ *
+ * Return: the number of strings inserted, from 0 to @n
+ */
+int q_insert_tail_bulk(struct list_head *head, char **sv, int n);
+
 /**
  * q_remove_head() - Remove the element from head of queue
  * @head: header of queue
@@ -86,6 +181,8 @@ bool q_insert_tail(struct list_head *head, char *s);
  *
  * If sp is non-NULL and an element is removed, copy the removed string to *sp
  * (up to a maximum of bufsize-1 characters, plus a null terminator.)
+ * Only the string and its terminator are written; the rest of sp is left
+ * untouched.
  *
  * NOTE: "remove" is different from "delete"
  * The space used by the list element and the string should not be freed.
@@ -108,17 +205,78 @@ element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize);
  */
 element_t *q_remove_tail(struct list_head *head, char *sp, size_t bufsize);
 
+/**
+ * q_remove_head_nocopy() - Remove the element from head of queue, no copy
+ * @head: header of queue
+ * @value: receives the removed string, may be NULL
+ *
+ * Like q_remove_head(), but instead of copying the string, hand the caller
+ * the value pointer of the element itself.  It stays valid until the element
+ * is released with q_release_element().
+ *
+ * Return: the pointer to element, %NULL if queue is NULL or empty.
+ */
+element_t *q_remove_head_nocopy(struct list_head *head, char **value);
+
+/**
+ * q_remove_tail_nocopy() - Remove the element from tail of queue, no copy
+ * @head: header of queue
+ * @value: receives the removed string, may be NULL
+ *
+ * See q_remove_head_nocopy().
+ *
+ * Return: the pointer to element, %NULL if queue is NULL or empty.
+ */
+element_t *q_remove_tail_nocopy(struct list_head *head, char **value);
+
+/**
+ * q_remove_head_n() - Remove up to n elements from head of queue at once
+ * @head: header of queue
+ * @out: list which receives the removed elements at its tail
+ * @n: maximum number of elements would be removed
+ *
+ * The removed elements keep their queue order and are detached as one
+ * sublist, without copying any string out.  They still have to be released
+ * with q_release_element().  Removing the whole queue takes constant time;
+ * otherwise the cost is proportional to @n, whatever the size of the queue.
+ *
+ * Return: the number of elements removed, 0 if queue is NULL or empty.
+ */
+int q_remove_head_n(struct list_head *head, struct list_head *out, int n);
+
+/**
+ * q_remove_tail_n() - Remove up to n elements from tail of queue at once
+ * @head: header of queue
+ * @out: list which receives the removed elements at its tail
+ * @n: maximum number of elements would be removed
+ *
+ * See q_remove_head_n().  The element q_remove_tail() would have returned
+ * ends up last in @out.
+ *
+ * Return: the number of elements removed, 0 if queue is NULL or empty.
+ */
+int q_remove_tail_n(struct list_head *head, struct list_head *out, int n);
+
 /**
  * q_release_element() - Release the element
  * @e: element would be released
  *
+ * Pooled elements are handed back to the pool they were carved from.
  * This function is intended for internal use only.
  */
-static inline void q_release_element(element_t *e)
-{
-    test_free(e->value);
-    test_free(e);
-}
+void q_release_element(element_t *e);
+
+/**
+ * q_peek() - Get an element at a given position without removing it
+ * @head: header of queue
+ * @i: position counted from the head, or from the tail when negative
+ *
+ * Position 0 is the head and -1 the tail.  Works on ring queues without
+ * flattening them, in constant time, and takes O(min(i, n - i)) on lists.
+ *
+ * Return: the pointer to element, %NULL if queue is NULL or i is out of range
+ */
+element_t *q_peek(struct list_head *head, int i);
 
 /**
  * q_size() - Get the size of the queue
@@ -155,6 +313,23 @@ bool q_delete_mid(struct list_head *head);
  */
 bool q_delete_dup(struct list_head *head);
 
+/**
+ * q_delete_dup_unsorted() - Delete duplicate strings from an unsorted queue
+ * @head: header of queue
+ * @keep_first: keep the first occurrence of every duplicate string
+ *
+ * Unlike q_delete_dup(), duplicates need not be adjacent.  Strings are
+ * tracked in a hash table, so the queue is deleted from in a single pass
+ * and O(n) expected time.  Without @keep_first, every string occurring more
+ * than once is deleted altogether, as q_delete_dup() does on a sorted queue.
+ * Otherwise only the later occurrences are, and the order of the remaining
+ * elements is preserved in both cases.
+ *
+ * Return: true for success, false if list is NULL or the table could not be
+ * allocated.
+ */
+bool q_delete_dup_unsorted(struct list_head *head, bool keep_first);
+
 /**
  * q_swap() - Swap every two adjacent nodes
  * @head: header of queue
@@ -196,10 +371,62 @@ void q_reverseK(struct list_head *head, int k);
  * @descend: whether or not to sort in descending order
  *
  * No effect if queue is NULL or empty. If there has only one element, do
- * nothing.
+ * nothing.  The sort is stable: elements comparing equal keep their order.
  */
 void q_sort(struct list_head *head, bool descend);
 
+/**
+ * q_set_sort_threads() - Set the number of threads q_sort() may use
+ * @n: number of threads, clamped to the range 1 to 16
+ *
+ * With more than one thread, q_sort() cuts the queue into one segment per
+ * thread, sorts the segments concurrently and merges them pairwise in
+ * parallel.  Small queues are still sorted on the calling thread.  Nothing
+ * is allocated through the queue allocator either way.
+ */
+void q_set_sort_threads(int n);
+
+/**
+ * q_use_radix_sort() - Select the algorithm q_sort() uses
+ * @enable: sort by MSD radix sort instead of merge sort
+ *
+ * Radix sort moves elements into one bucket per byte value, a byte at a
+ * time, and only merge sorts buckets that have become small.  It is stable
+ * and allocates nothing either.  Disabled by default.
+ */
+void q_use_radix_sort(bool enable);
+
+/**
+ * q_select_kth() - Find the element at a given position in sorting order
+ * @head: header of queue
+ * @k: position, from 0 for the first element in sorting order
+ * @descend: whether the sorting order is descending
+ *
+ * The queue is partitioned around the element found: afterwards it sits at
+ * position k, the elements ahead of it are those sorted before it and the
+ * ones after it are those sorted after it, in no particular order.  Runs in
+ * expected O(n) time with quickselect, bounded by O(n log n) as it falls
+ * back on sorting when partitioning does not converge.  Nothing is
+ * allocated.
+ *
+ * Return: the element, NULL if queue is NULL or k is out of range
+ */
+element_t *q_select_kth(struct list_head *head, int k, bool descend);
+
+/**
+ * q_top_k() - Bring the first k elements in sorting order to the front
+ * @head: header of queue
+ * @k: number of elements wanted
+ * @descend: whether the sorting order is descending
+ *
+ * The first k elements of the queue end up sorted as q_sort() would leave
+ * them, followed by the remaining elements in no particular order.  Takes
+ * O(n + k log k) expected time and allocates nothing.
+ *
+ * Return: the number of elements brought to the front, at most k
+ */
+int q_top_k(struct list_head *head, int k, bool descend);
+
 /**
  * q_ascend() - Remove every node which has a node with a strictly less
  * value anywhere to the right side of it.
@@ -0,0 +1,28 @@
+# Profile where queue operations allocate, with and without element pools
+option fail 0
+option malloc 0
+option profile 1
+new
+ih RAND 10000
+it RAND 10000
+ih dolphin 1000
+it gerbil 1000
+rh * 5000
+rt * 5000
+sort
+dedup
+free
+alloc_stats
+alloc_stats reset
+option pool 1
+new
+ih RAND 10000
+it RAND 10000
+ih dolphin 1000
+it gerbil 1000
+rh * 5000
+rt * 5000
+sort
+dedup
+free
+alloc_stats
@@ -0,0 +1,920 @@
+# Time deleting duplicates of 65000 unsorted strings, 15000 of them
+# repeated: hash based dedup modes 1 and 2 against sort followed by dedup
+option fail 0
+option malloc 0
+new
+ih RAND 50000
+it jkxlhtpdpx 50
+it rzwub 50
+it numdmn 50
+it fktkggy 50
+it fvrgoqgx 50
+it krwlyn 50
+it wqsesbaplw 50
+it jkeccorlxb 50
+it guamrsuq 50
+it uuzlcvggp 50
+it qrjxrufq 50
+it avcouinr 50
+it hprutt 50
+it gsvll 50
+it sljuzsa 50
+it putzfdoje 50
+it wdaboz 50
+it xwezklcvpc 50
+it umstgqskzy 50
+it satcccud 50
+it mhskge 50
+it hppeknp 50
+it ronzm 50
+it rijvmtgje 50
+it fhiyl 50
+it qispgnrdq 50
+it bgeha 50
+it wquyk 50
+it qzakc 50
+it cavaggbp 50
+it osgqhuj 50
+it emogayihye 50
+it spsemf 50
+it mrzsdpcwf 50
+it rnyipag 50
+it ejhthxgfxu 50
+it vwopswcyh 50
+it zapsatvm 50
+it ytvpialj 50
+it tcpahwd 50
+it mouxtufta 50
+it inohb 50
+it batucpc 50
+it iggxa 50
+it kjmcccgsu 50
+it fjvdsb 50
+it vocydk 50
+it rgurug 50
+it atllto 50
+it bqihx 50
+it wqqtyfmzw 50
+it cnxmeo 50
+it idxxyfm 50
+it vophkmv 50
+it egoia 50
+it mdnnrzw 50
+it tqspegfdg 50
+it gunzzyg 50
+it dehexc 50
+it vgzcpdaby 50
+it ryooqsgf 50
+it aizsja 50
+it oorcqyqa 50
+it vmsfrc 50
+it wmncsugy 50
+it kdgntaiew 50
+it mintpjqfxc 50
+it walqcbo 50
+it tmarb 50
+it udodu 50
+it qpugwdym 50
+it vtgqfy 50
+it uqpvkwto 50
+it cbitbvw 50
+it plbwci 50
+it nxkmxws 50
+it wikyh 50
+it mgxfcz 50
+it fwayprw 50
+it jacsydmdj 50
+it vzepeqx 50
+it fjlqs 50
+it fmtusd 50
+it gmuvza 50
+it hivjk 50
+it dqtiwgwqn 50
+it gvmptcnbd 50
+it dopign 50
+it jpdalut 50
+it wdghmcjrzk 50
+it nzbfr 50
+it onqlngtl 50
+it olxlmgtf 50
+it ikcjkanyde 50
+it munqt 50
+it okugdxz 50
+it uwbgf 50
+it cleokv 50
+it cbbghtayo 50
+it grtsehxuz 50
+it uqpvkwto 50
+it guamrsuq 50
+it egoia 50
+it tqspegfdg 50
+it fhiyl 50
+it wdghmcjrzk 50
+it rgurug 50
+it xwezklcvpc 50
+it gmuvza 50
+it dqtiwgwqn 50
+it vocydk 50
+it mgxfcz 50
+it qpugwdym 50
+it tmarb 50
+it hivjk 50
+it oorcqyqa 50
+it fmtusd 50
+it wqsesbaplw 50
+it nzbfr 50
+it numdmn 50
+it qrjxrufq 50
+it ytvpialj 50
+it dehexc 50
+it dopign 50
+it satcccud 50
+it zapsatvm 50
+it bgeha 50
+it mintpjqfxc 50
+it munqt 50
+it gsvll 50
+it jkxlhtpdpx 50
+it batucpc 50
+it grtsehxuz 50
+it hprutt 50
+it osgqhuj 50
+it wikyh 50
+it putzfdoje 50
+it jpdalut 50
+it wquyk 50
+it inohb 50
+it vwopswcyh 50
+it fktkggy 50
+it rzwub 50
+it avcouinr 50
+it mdnnrzw 50
+it olxlmgtf 50
+it vzepeqx 50
+it cbbghtayo 50
+it sljuzsa 50
+it rijvmtgje 50
+it mhskge 50
+it wmncsugy 50
+it kdgntaiew 50
+it aizsja 50
+it vtgqfy 50
+it bqihx 50
+it hppeknp 50
+it emogayihye 50
+it gvmptcnbd 50
+it fvrgoqgx 50
+it ejhthxgfxu 50
+it krwlyn 50
+it mrzsdpcwf 50
+it jacsydmdj 50
+it fwayprw 50
+it fjvdsb 50
+it fjlqs 50
+it idxxyfm 50
+it umstgqskzy 50
+it jkeccorlxb 50
+it plbwci 50
+it nxkmxws 50
+it wdaboz 50
+it qispgnrdq 50
+it cbitbvw 50
+it ikcjkanyde 50
+it iggxa 50
+it spsemf 50
+it atllto 50
+it uuzlcvggp 50
+it cavaggbp 50
+it onqlngtl 50
+it udodu 50
+it gunzzyg 50
+it ronzm 50
+it tcpahwd 50
+it walqcbo 50
+it wqqtyfmzw 50
+it kjmcccgsu 50
+it qzakc 50
+it vgzcpdaby 50
+it vophkmv 50
+it vmsfrc 50
+it cleokv 50
+it rnyipag 50
+it mouxtufta 50
+it uwbgf 50
+it cnxmeo 50
+it ryooqsgf 50
+it okugdxz 50
+it ytvpialj 50
+it inohb 50
+it vgzcpdaby 50
+it grtsehxuz 50
+it wmncsugy 50
+it onqlngtl 50
+it tcpahwd 50
+it vwopswcyh 50
+it krwlyn 50
+it vophkmv 50
+it nxkmxws 50
+it kjmcccgsu 50
+it fjlqs 50
+it dopign 50
+it hivjk 50
+it olxlmgtf 50
+it uqpvkwto 50
+it aizsja 50
+it tqspegfdg 50
+it guamrsuq 50
+it bgeha 50
+it rgurug 50
+it satcccud 50
+it mdnnrzw 50
+it tmarb 50
+it qpugwdym 50
+it wdghmcjrzk 50
+it vtgqfy 50
+it vocydk 50
+it uuzlcvggp 50
+it qispgnrdq 50
+it batucpc 50
+it mgxfcz 50
+it wquyk 50
+it ronzm 50
+it mouxtufta 50
+it rijvmtgje 50
+it mhskge 50
+it hprutt 50
+it oorcqyqa 50
+it mintpjqfxc 50
+it udodu 50
+it wdaboz 50
+it cbitbvw 50
+it uwbgf 50
+it bqihx 50
+it hppeknp 50
+it walqcbo 50
+it zapsatvm 50
+it cavaggbp 50
+it rnyipag 50
+it cnxmeo 50
+it ikcjkanyde 50
+it fktkggy 50
+it osgqhuj 50
+it cleokv 50
+it qzakc 50
+it putzfdoje 50
+it numdmn 50
+it xwezklcvpc 50
+it qrjxrufq 50
+it fhiyl 50
+it munqt 50
+it sljuzsa 50
+it vzepeqx 50
+it gunzzyg 50
+it vmsfrc 50
+it cbbghtayo 50
+it atllto 50
+it nzbfr 50
+it egoia 50
+it rzwub 50
+it emogayihye 50
+it kdgntaiew 50
+it jacsydmdj 50
+it wqqtyfmzw 50
+it dqtiwgwqn 50
+it dehexc 50
+it iggxa 50
+it ryooqsgf 50
+it jkeccorlxb 50
+it fwayprw 50
+it fvrgoqgx 50
+it wikyh 50
+it fmtusd 50
+it gsvll 50
+it okugdxz 50
+it wqsesbaplw 50
+it fjvdsb 50
+it gmuvza 50
+it avcouinr 50
+it umstgqskzy 50
+it plbwci 50
+it jkxlhtpdpx 50
+it ejhthxgfxu 50
+it idxxyfm 50
+it jpdalut 50
+it mrzsdpcwf 50
+it spsemf 50
+it gvmptcnbd 50
+time dedup 1
+size
+free
+new
+ih RAND 50000
+it jkxlhtpdpx 50
+it rzwub 50
+it numdmn 50
+it fktkggy 50
+it fvrgoqgx 50
+it krwlyn 50
+it wqsesbaplw 50
+it jkeccorlxb 50
+it guamrsuq 50
+it uuzlcvggp 50
+it qrjxrufq 50
+it avcouinr 50
+it hprutt 50
+it gsvll 50
+it sljuzsa 50
+it putzfdoje 50
+it wdaboz 50
+it xwezklcvpc 50
+it umstgqskzy 50
+it satcccud 50
+it mhskge 50
+it hppeknp 50
+it ronzm 50
+it rijvmtgje 50
+it fhiyl 50
+it qispgnrdq 50
+it bgeha 50
+it wquyk 50
+it qzakc 50
+it cavaggbp 50
+it osgqhuj 50
+it emogayihye 50
+it spsemf 50
+it mrzsdpcwf 50
+it rnyipag 50
+it ejhthxgfxu 50
+it vwopswcyh 50
+it zapsatvm 50
+it ytvpialj 50
+it tcpahwd 50
+it mouxtufta 50
+it inohb 50
+it batucpc 50
+it iggxa 50
+it kjmcccgsu 50
+it fjvdsb 50
+it vocydk 50
+it rgurug 50
+it atllto 50
+it bqihx 50
+it wqqtyfmzw 50
+it cnxmeo 50
+it idxxyfm 50
+it vophkmv 50
+it egoia 50
+it mdnnrzw 50
+it tqspegfdg 50
+it gunzzyg 50
+it dehexc 50
+it vgzcpdaby 50
+it ryooqsgf 50
+it aizsja 50
+it oorcqyqa 50
+it vmsfrc 50
+it wmncsugy 50
+it kdgntaiew 50
+it mintpjqfxc 50
+it walqcbo 50
+it tmarb 50
+it udodu 50
+it qpugwdym 50
+it vtgqfy 50
+it uqpvkwto 50
+it cbitbvw 50
+it plbwci 50
+it nxkmxws 50
+it wikyh 50
+it mgxfcz 50
+it fwayprw 50
+it jacsydmdj 50
+it vzepeqx 50
+it fjlqs 50
+it fmtusd 50
+it gmuvza 50
+it hivjk 50
+it dqtiwgwqn 50
+it gvmptcnbd 50
+it dopign 50
+it jpdalut 50
+it wdghmcjrzk 50
+it nzbfr 50
+it onqlngtl 50
+it olxlmgtf 50
+it ikcjkanyde 50
+it munqt 50
+it okugdxz 50
+it uwbgf 50
+it cleokv 50
+it cbbghtayo 50
+it grtsehxuz 50
+it uqpvkwto 50
+it guamrsuq 50
+it egoia 50
+it tqspegfdg 50
+it fhiyl 50
+it wdghmcjrzk 50
+it rgurug 50
+it xwezklcvpc 50
+it gmuvza 50
+it dqtiwgwqn 50
+it vocydk 50
+it mgxfcz 50
+it qpugwdym 50
+it tmarb 50
+it hivjk 50
+it oorcqyqa 50
+it fmtusd 50
+it wqsesbaplw 50
+it nzbfr 50
+it numdmn 50
+it qrjxrufq 50
+it ytvpialj 50
+it dehexc 50
+it dopign 50
+it satcccud 50
+it zapsatvm 50
+it bgeha 50
+it mintpjqfxc 50
+it munqt 50
+it gsvll 50
+it jkxlhtpdpx 50
+it batucpc 50
+it grtsehxuz 50
+it hprutt 50
+it osgqhuj 50
+it wikyh 50
+it putzfdoje 50
+it jpdalut 50
+it wquyk 50
+it inohb 50
+it vwopswcyh 50
+it fktkggy 50
+it rzwub 50
+it avcouinr 50
+it mdnnrzw 50
+it olxlmgtf 50
+it vzepeqx 50
+it cbbghtayo 50
+it sljuzsa 50
+it rijvmtgje 50
+it mhskge 50
+it wmncsugy 50
+it kdgntaiew 50
+it aizsja 50
+it vtgqfy 50
+it bqihx 50
+it hppeknp 50
+it emogayihye 50
+it gvmptcnbd 50
+it fvrgoqgx 50
+it ejhthxgfxu 50
+it krwlyn 50
+it mrzsdpcwf 50
+it jacsydmdj 50
+it fwayprw 50
+it fjvdsb 50
+it fjlqs 50
+it idxxyfm 50
+it umstgqskzy 50
+it jkeccorlxb 50
+it plbwci 50
+it nxkmxws 50
+it wdaboz 50
+it qispgnrdq 50
+it cbitbvw 50
+it ikcjkanyde 50
+it iggxa 50
+it spsemf 50
+it atllto 50
+it uuzlcvggp 50
+it cavaggbp 50
+it onqlngtl 50
+it udodu 50
+it gunzzyg 50
+it ronzm 50
+it tcpahwd 50
+it walqcbo 50
+it wqqtyfmzw 50
+it kjmcccgsu 50
+it qzakc 50
+it vgzcpdaby 50
+it vophkmv 50
+it vmsfrc 50
+it cleokv 50
+it rnyipag 50
+it mouxtufta 50
+it uwbgf 50
+it cnxmeo 50
+it ryooqsgf 50
+it okugdxz 50
+it ytvpialj 50
+it inohb 50
+it vgzcpdaby 50
+it grtsehxuz 50
+it wmncsugy 50
+it onqlngtl 50
+it tcpahwd 50
+it vwopswcyh 50
+it krwlyn 50
+it vophkmv 50
+it nxkmxws 50
+it kjmcccgsu 50
+it fjlqs 50
+it dopign 50
+it hivjk 50
+it olxlmgtf 50
+it uqpvkwto 50
+it aizsja 50
+it tqspegfdg 50
+it guamrsuq 50
+it bgeha 50
+it rgurug 50
+it satcccud 50
+it mdnnrzw 50
+it tmarb 50
+it qpugwdym 50
+it wdghmcjrzk 50
+it vtgqfy 50
+it vocydk 50
+it uuzlcvggp 50
+it qispgnrdq 50
+it batucpc 50
+it mgxfcz 50
+it wquyk 50
+it ronzm 50
+it mouxtufta 50
+it rijvmtgje 50
+it mhskge 50
+it hprutt 50
+it oorcqyqa 50
+it mintpjqfxc 50
+it udodu 50
+it wdaboz 50
+it cbitbvw 50
+it uwbgf 50
+it bqihx 50
+it hppeknp 50
+it walqcbo 50
+it zapsatvm 50
+it cavaggbp 50
+it rnyipag 50
+it cnxmeo 50
+it ikcjkanyde 50
+it fktkggy 50
+it osgqhuj 50
+it cleokv 50
+it qzakc 50
+it putzfdoje 50
+it numdmn 50
+it xwezklcvpc 50
+it qrjxrufq 50
+it fhiyl 50
+it munqt 50
+it sljuzsa 50
+it vzepeqx 50
+it gunzzyg 50
+it vmsfrc 50
+it cbbghtayo 50
+it atllto 50
+it nzbfr 50
+it egoia 50
+it rzwub 50
+it emogayihye 50
+it kdgntaiew 50
+it jacsydmdj 50
+it wqqtyfmzw 50
+it dqtiwgwqn 50
+it dehexc 50
+it iggxa 50
+it ryooqsgf 50
+it jkeccorlxb 50
+it fwayprw 50
+it fvrgoqgx 50
+it wikyh 50
+it fmtusd 50
+it gsvll 50
+it okugdxz 50
+it wqsesbaplw 50
+it fjvdsb 50
+it gmuvza 50
+it avcouinr 50
+it umstgqskzy 50
+it plbwci 50
+it jkxlhtpdpx 50
+it ejhthxgfxu 50
+it idxxyfm 50
+it jpdalut 50
+it mrzsdpcwf 50
+it spsemf 50
+it gvmptcnbd 50
+time dedup 2
+size
+free
+new
+ih RAND 50000
+it jkxlhtpdpx 50
+it rzwub 50
+it numdmn 50
+it fktkggy 50
+it fvrgoqgx 50
+it krwlyn 50
+it wqsesbaplw 50
+it jkeccorlxb 50
+it guamrsuq 50
+it uuzlcvggp 50
+it qrjxrufq 50
+it avcouinr 50
+it hprutt 50
+it gsvll 50
+it sljuzsa 50
+it putzfdoje 50
+it wdaboz 50
+it xwezklcvpc 50
+it umstgqskzy 50
+it satcccud 50
+it mhskge 50
+it hppeknp 50
+it ronzm 50
+it rijvmtgje 50
+it fhiyl 50
+it qispgnrdq 50
+it bgeha 50
+it wquyk 50
+it qzakc 50
+it cavaggbp 50
+it osgqhuj 50
+it emogayihye 50
+it spsemf 50
+it mrzsdpcwf 50
+it rnyipag 50
+it ejhthxgfxu 50
+it vwopswcyh 50
+it zapsatvm 50
+it ytvpialj 50
+it tcpahwd 50
+it mouxtufta 50
+it inohb 50
+it batucpc 50
+it iggxa 50
+it kjmcccgsu 50
+it fjvdsb 50
+it vocydk 50
+it rgurug 50
+it atllto 50
+it bqihx 50
+it wqqtyfmzw 50
+it cnxmeo 50
+it idxxyfm 50
+it vophkmv 50
+it egoia 50
+it mdnnrzw 50
+it tqspegfdg 50
+it gunzzyg 50
+it dehexc 50
+it vgzcpdaby 50
+it ryooqsgf 50
+it aizsja 50
+it oorcqyqa 50
+it vmsfrc 50
+it wmncsugy 50
+it kdgntaiew 50
+it mintpjqfxc 50
+it walqcbo 50
+it tmarb 50
+it udodu 50
+it qpugwdym 50
+it vtgqfy 50
+it uqpvkwto 50
+it cbitbvw 50
+it plbwci 50
+it nxkmxws 50
+it wikyh 50
+it mgxfcz 50
+it fwayprw 50
+it jacsydmdj 50
+it vzepeqx 50
+it fjlqs 50
+it fmtusd 50
+it gmuvza 50
+it hivjk 50
+it dqtiwgwqn 50
+it gvmptcnbd 50
+it dopign 50
+it jpdalut 50
+it wdghmcjrzk 50
+it nzbfr 50
+it onqlngtl 50
+it olxlmgtf 50
+it ikcjkanyde 50
+it munqt 50
+it okugdxz 50
+it uwbgf 50
+it cleokv 50
+it cbbghtayo 50
+it grtsehxuz 50
+it uqpvkwto 50
+it guamrsuq 50
+it egoia 50
+it tqspegfdg 50
+it fhiyl 50
+it wdghmcjrzk 50
+it rgurug 50
+it xwezklcvpc 50
+it gmuvza 50
+it dqtiwgwqn 50
+it vocydk 50
+it mgxfcz 50
+it qpugwdym 50
+it tmarb 50
+it hivjk 50
+it oorcqyqa 50
+it fmtusd 50
+it wqsesbaplw 50
+it nzbfr 50
+it numdmn 50
+it qrjxrufq 50
+it ytvpialj 50
+it dehexc 50
+it dopign 50
+it satcccud 50
+it zapsatvm 50
+it bgeha 50
+it mintpjqfxc 50
+it munqt 50
+it gsvll 50
+it jkxlhtpdpx 50
+it batucpc 50
+it grtsehxuz 50
+it hprutt 50
+it osgqhuj 50
+it wikyh 50
+it putzfdoje 50
+it jpdalut 50
+it wquyk 50
+it inohb 50
+it vwopswcyh 50
+it fktkggy 50
+it rzwub 50
+it avcouinr 50
+it mdnnrzw 50
+it olxlmgtf 50
+it vzepeqx 50
+it cbbghtayo 50
+it sljuzsa 50
+it rijvmtgje 50
+it mhskge 50
+it wmncsugy 50
+it kdgntaiew 50
+it aizsja 50
+it vtgqfy 50
+it bqihx 50
+it hppeknp 50
+it emogayihye 50
+it gvmptcnbd 50
+it fvrgoqgx 50
+it ejhthxgfxu 50
+it krwlyn 50
+it mrzsdpcwf 50
+it jacsydmdj 50
+it fwayprw 50
+it fjvdsb 50
+it fjlqs 50
+it idxxyfm 50
+it umstgqskzy 50
+it jkeccorlxb 50
+it plbwci 50
+it nxkmxws 50
+it wdaboz 50
+it qispgnrdq 50
+it cbitbvw 50
+it ikcjkanyde 50
+it iggxa 50
+it spsemf 50
+it atllto 50
+it uuzlcvggp 50
+it cavaggbp 50
+it onqlngtl 50
+it udodu 50
+it gunzzyg 50
+it ronzm 50
+it tcpahwd 50
+it walqcbo 50
+it wqqtyfmzw 50
+it kjmcccgsu 50
+it qzakc 50
+it vgzcpdaby 50
+it vophkmv 50
+it vmsfrc 50
+it cleokv 50
+it rnyipag 50
+it mouxtufta 50
+it uwbgf 50
+it cnxmeo 50
+it ryooqsgf 50
+it okugdxz 50
+it ytvpialj 50
+it inohb 50
+it vgzcpdaby 50
+it grtsehxuz 50
+it wmncsugy 50
+it onqlngtl 50
+it tcpahwd 50
+it vwopswcyh 50
+it krwlyn 50
+it vophkmv 50
+it nxkmxws 50
+it kjmcccgsu 50
+it fjlqs 50
+it dopign 50
+it hivjk 50
+it olxlmgtf 50
+it uqpvkwto 50
+it aizsja 50
+it tqspegfdg 50
+it guamrsuq 50
+it bgeha 50
+it rgurug 50
+it satcccud 50
+it mdnnrzw 50
+it tmarb 50
+it qpugwdym 50
+it wdghmcjrzk 50
+it vtgqfy 50
+it vocydk 50
+it uuzlcvggp 50
+it qispgnrdq 50
+it batucpc 50
+it mgxfcz 50
+it wquyk 50
+it ronzm 50
+it mouxtufta 50
+it rijvmtgje 50
+it mhskge 50
+it hprutt 50
+it oorcqyqa 50
+it mintpjqfxc 50
+it udodu 50
+it wdaboz 50
+it cbitbvw 50
+it uwbgf 50
+it bqihx 50
+it hppeknp 50
+it walqcbo 50
+it zapsatvm 50
+it cavaggbp 50
+it rnyipag 50
+it cnxmeo 50
+it ikcjkanyde 50
+it fktkggy 50
+it osgqhuj 50
+it cleokv 50
+it qzakc 50
+it putzfdoje 50
+it numdmn 50
+it xwezklcvpc 50
+it qrjxrufq 50
+it fhiyl 50
+it munqt 50
+it sljuzsa 50
+it vzepeqx 50
+it gunzzyg 50
+it vmsfrc 50
+it cbbghtayo 50
+it atllto 50
+it nzbfr 50
+it egoia 50
+it rzwub 50
+it emogayihye 50
+it kdgntaiew 50
+it jacsydmdj 50
+it wqqtyfmzw 50
+it dqtiwgwqn 50
+it dehexc 50
+it iggxa 50
+it ryooqsgf 50
+it jkeccorlxb 50
+it fwayprw 50
+it fvrgoqgx 50
+it wikyh 50
+it fmtusd 50
+it gsvll 50
+it okugdxz 50
+it wqsesbaplw 50
+it fjvdsb 50
+it gmuvza 50
+it avcouinr 50
+it umstgqskzy 50
+it plbwci 50
+it jkxlhtpdpx 50
+it ejhthxgfxu 50
+it idxxyfm 50
+it jpdalut 50
+it mrzsdpcwf 50
+it spsemf 50
+it gvmptcnbd 50
+time sort
+time dedup
+size
+free
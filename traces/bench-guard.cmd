@@ -0,0 +1,20 @@
+# Time a queue workload with no guard pages, with one block in 64 and with
+# every block placed against a guard page
+option fail 0
+option malloc 0
+option guard 0
+new
+time it RAND 100000
+time sort
+time free
+option guard 64
+new
+time it RAND 100000
+time sort
+time free
+option guard 1
+new
+time it RAND 100000
+time sort
+time free
+option guard 0
@@ -0,0 +1,15 @@
+# Time list traversals and sort with the element layout chosen at build time
+# Compare 'make clean qtest' with 'make clean qtest LAYOUT=unrolled'
+# In debug mode every size command walks the whole list once
+# Elements inserted at the tail are laid out in list order by the unrolled
+# layout; sort only relinks them, so the last traversal follows random order
+option fail 0
+option malloc 0
+option debug 1
+new
+it RAND 200000
+time size
+time size
+time sort
+time size
+free
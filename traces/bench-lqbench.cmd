@@ -0,0 +1,6 @@
+# Two-lock deque against a single global mutex, with growing thread counts
+# Per-end locks only pay off with producers and consumers on separate cores
+lqbench 1 1 200000
+lqbench 2 2 100000
+lqbench 4 4 50000
+lqbench 8 8 25000
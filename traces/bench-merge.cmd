@@ -0,0 +1,1506 @@
+# Time merging 500 sorted queues of 500 random strings each
+option fail 0
+option malloc 0
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+new
+ih RAND 500
+sort
+time merge
+size
+free
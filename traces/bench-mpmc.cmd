@@ -0,0 +1,7 @@
+# Throughput and latency of the lock-free queue with growing thread counts
+mpmc 1 1 200000
+mpmc 2 2 200000
+mpmc 4 4 100000
+mpmc 8 8 50000
+mpmc 8 1 50000
+mpmc 1 8 200000
@@ -0,0 +1,17 @@
+# Time insertion and freeing of 1000000 elements under each poisoning policy:
+# full fill, canaries only, and one block in 16 filled
+option fail 0
+option malloc 0
+option poison 0
+new
+time it abcdefghijklmnopqrstuvwxyz 1000000
+time free
+option poison 1
+new
+time it abcdefghijklmnopqrstuvwxyz 1000000
+time free
+option poison 16
+new
+time it abcdefghijklmnopqrstuvwxyz 1000000
+time free
+option poison 0
@@ -0,0 +1,14 @@
+# Compare insertion throughput of malloc'ed and pooled queue elements
+# Divide the element count by the reported delta time for inserts/second
+option fail 0
+option malloc 0
+option pool 0
+new
+time ih dolphin 1000000
+time it gerbil 1000000
+time free
+option pool 1
+new
+time ih dolphin 1000000
+time it gerbil 1000000
+time free
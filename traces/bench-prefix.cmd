@@ -0,0 +1,18 @@
+# Time the 100k RAND sort of trace-15 with and without prefix keys
+# Run under 'perf stat -e cache-misses' to compare cache misses as well
+option fail 0
+option malloc 0
+option prefix 0
+new
+ih RAND 100000
+time sort
+reverse
+time sort
+free
+option prefix 1
+new
+ih RAND 100000
+time sort
+reverse
+time sort
+free
@@ -0,0 +1,12 @@
+# Time reversing 1000000 elements in groups of K for several K
+option fail 0
+option malloc 0
+new
+it RAND 1000000
+time reverseK 2
+time reverseK 3
+time reverseK 8
+time reverseK 64
+time reverseK 999999
+time reverseK 1000000
+free
@@ -0,0 +1,22 @@
+# Compare list and ring deque backends on insertion and removal at both ends
+# Each command handles 300000 elements; divide by the delta time for ops/second
+option fail 0
+option malloc 0
+option ring 0
+new
+time it dolphin 300000
+time rh * 299999
+time ih gerbil 300000
+time rt * 299999
+rh
+rt
+free
+option ring 1
+new
+time it dolphin 300000
+time rh * 299999
+time ih gerbil 300000
+time rt * 299999
+rh
+rt
+free
@@ -0,0 +1,16 @@
+# Find the median and the first 100 of 400000 random strings by selection,
+# against sorting all of them
+option fail 0
+option malloc 0
+new
+it RAND 400000
+time kth 200000
+free
+new
+it RAND 400000
+time topk 100
+free
+new
+it RAND 400000
+time sort
+free
@@ -0,0 +1,31 @@
+# Time sort on the random, reverse-sorted and already sorted inputs of trace-15
+# Reverse-sorted and sorted input take the O(n) presorted path of q_sort();
+# swapping adjacent pairs of the sorted queue gives nearly sorted input that
+# still goes through the sort engine
+option fail 0
+option malloc 0
+new
+ih RAND 100000
+time sort
+reverse
+time sort
+time sort
+swap
+time sort
+free
+new
+ih RAND 400000
+time sort
+reverse
+time sort
+time sort
+swap
+time sort
+free
+# Compare merge sort and radix sort over six input distributions, from 1024
+# up to 262144 elements; "bench sort" alone goes up to 4194304
+option sortalgo 0
+bench sort 262144
+option sortalgo 1
+bench sort 262144
+option sortalgo 0
@@ -0,0 +1,35 @@
+# Compare sort throughput at 1, 2, 4 and 8 threads on trace-14/15 style input
+# Each block sorts random input, then the sorted queue with adjacent pairs
+# swapped: nearly sorted input that, unlike a reversed queue, does not take
+# the presorted path of q_sort()
+option fail 0
+option malloc 0
+option threads 1
+new
+ih RAND 200000
+time sort
+swap
+time sort
+free
+option threads 2
+new
+ih RAND 200000
+time sort
+swap
+time sort
+free
+option threads 4
+new
+ih RAND 200000
+time sort
+swap
+time sort
+free
+option threads 8
+new
+ih RAND 200000
+time sort
+swap
+time sort
+free
+option threads 1
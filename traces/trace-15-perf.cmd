@@ -22,3 +22,18 @@ sort
 reverse
 sort
 free
+# Compare merge sort with MSD radix sort: the ratio of the delta times
+# reported is the speedup of radix sort
+option sortalgo 0
+new
+ih RAND 100000
+time sort
+free
+option sortalgo 1
+new
+ih RAND 100000
+time sort
+reverse
+time sort
+free
+option sortalgo 0
@@ -0,0 +1,53 @@
+# Test of ring deque growth through realloc, with and without malloc failure,
+# and of realloc itself: growing, shrinking, freeing and moving guarded blocks
+option fail 22
+option malloc 0
+option ring 1
+new
+ih dolphin 20
+it gerbil 20
+ih bear 100
+it meerkat 100
+rh bear 100
+rt meerkat 100
+rh dolphin 20
+rt gerbil 20
+free
+new
+ih jaguar 14
+option malloc 25
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+ih jaguar
+it tiger
+option malloc 0
+size
+reverse
+free
+realloc
+realloc 4096
+realloc corrupt
+option guard 1
+realloc
+realloc 4096
+option guard 0